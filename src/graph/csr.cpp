@@ -0,0 +1,285 @@
+#include "csr.h"
+
+CSRGraph::CSRGraph() : offsets(1, 0) { attach(); }
+
+/**
+ * Builds the CSR representation of a pointer-based graph.
+ * Vertex indexes follow the order of the graph's vertex set.
+ * The coordinates of the vertexes are kept if all of them have one.
+ * When a vertex has several edges to the same destination,
+ * only the last one added is kept, as in its adjacency map.
+ * @param graph Graph to convert.
+ * @note Complexity: O(V + E log E)
+*/
+CSRGraph::CSRGraph(const Graph &graph)
+{
+	std::vector<CSREdge> edges;
+	coordinates = !graph.getVertexSet().empty();
+	for (auto vtx : graph.getVertexSet())
+	{
+		Info info = vtx->getInfo();
+		indexes.insert(vtx->getId(), ids.size());
+		ids.push_back(vtx->getId());
+		lats.push_back(info.lat);
+		lons.push_back(info.lon);
+		if (info.lat == -1 || info.lon == -1) coordinates = false;
+	}
+
+	for (size_t i = 0; i < ids.size(); i++)
+	{
+		for (auto edg : graph.getVertexSet()[i]->getAdj())
+			edges.push_back({(int)i, indexes.find(edg->getDest()->getId()), edg->getWeight()});
+	}
+
+	build(edges, false);
+	attach();
+}
+
+/**
+ * Builds a CSR graph from an edge list over dense indexes.
+ * Parallel edges are kept, as multigraphs are needed by some heuristics.
+ * @param ids Original id of each dense index.
+ * @param edges Edges, whose endpoints are indexes into ids.
+ * @param bidirectional If true, the reverse of every edge is also added.
+ * @note Complexity: O(V + E log E)
+*/
+CSRGraph::CSRGraph(const std::vector<int> &ids, const std::vector<CSREdge> &edges,
+	bool bidirectional) : ids(ids)
+{
+	buildIndexes();
+
+	std::vector<CSREdge> all(edges);
+	if (bidirectional)
+	{
+		all.reserve(edges.size() * 2);
+		for (auto &edg : edges)
+			all.push_back({edg.dest, edg.orig, edg.weight});
+	}
+
+	build(all, true);
+	attach();
+}
+
+CSRGraph::CSRGraph(const CSRGraph &other) { *this = other; }
+
+CSRGraph::CSRGraph(CSRGraph &&other) noexcept { *this = std::move(other); }
+
+CSRGraph &CSRGraph::operator=(const CSRGraph &other)
+{
+	if (this == &other) return *this;
+	ids = other.ids;
+	indexes = other.indexes;
+	offsets = other.offsets;
+	neighbors = other.neighbors;
+	weights = other.weights;
+	lats = other.lats;
+	lons = other.lons;
+	coordinates = other.coordinates;
+	backing = other.backing;
+	if (backing == nullptr) attach();
+	else
+	{
+		vertexCount = other.vertexCount;
+		edgeCount = other.edgeCount;
+		idsView = other.idsView;
+		offsetsView = other.offsetsView;
+		neighborsView = other.neighborsView;
+		weightsView = other.weightsView;
+		latsView = other.latsView;
+		lonsView = other.lonsView;
+	}
+	return *this;
+}
+
+CSRGraph &CSRGraph::operator=(CSRGraph &&other) noexcept
+{
+	if (this == &other) return *this;
+	ids = std::move(other.ids);
+	indexes = std::move(other.indexes);
+	offsets = std::move(other.offsets);
+	neighbors = std::move(other.neighbors);
+	weights = std::move(other.weights);
+	lats = std::move(other.lats);
+	lons = std::move(other.lons);
+	coordinates = other.coordinates;
+	backing = std::move(other.backing);
+	if (backing == nullptr) attach();
+	else
+	{
+		vertexCount = other.vertexCount;
+		edgeCount = other.edgeCount;
+		idsView = other.idsView;
+		offsetsView = other.offsetsView;
+		neighborsView = other.neighborsView;
+		weightsView = other.weightsView;
+		latsView = other.latsView;
+		lonsView = other.lonsView;
+	}
+	other.indexes.clear();
+	other.offsets.assign(1, 0);
+	other.coordinates = false;
+	other.backing.reset();
+	other.attach();
+	return *this;
+}
+
+/**
+ * Creates a graph over arrays it does not own, laid out as the ones it builds.
+ * Only the id lookup table is built.
+ * @param backing Handle keeping the arrays alive for as long as the graph (or a copy) exists.
+ * @param vertexCount Number of vertexes.
+ * @param edgeCount Number of directed edges.
+ * @param ids Original id of each dense index.
+ * @param offsets Start of the edge range of each vertex, followed by edgeCount.
+ * @param neighbors Destination of each edge, sorted by destination within each range.
+ * @param weights Weight of each edge.
+ * @param lats Latitude of each vertex.
+ * @param lons Longitude of each vertex.
+ * @param coordinates True if every vertex has coordinates.
+ * @note Complexity: O(V)
+*/
+CSRGraph CSRGraph::view(std::shared_ptr<const void> backing, int vertexCount, size_t edgeCount,
+	const int *ids, const size_t *offsets, const int *neighbors, const double *weights,
+	const double *lats, const double *lons, bool coordinates)
+{
+	CSRGraph graph;
+	graph.offsets.clear();
+	graph.backing = backing;
+	graph.vertexCount = vertexCount;
+	graph.edgeCount = edgeCount;
+	graph.idsView = ids;
+	graph.offsetsView = offsets;
+	graph.neighborsView = neighbors;
+	graph.weightsView = weights;
+	graph.latsView = lats;
+	graph.lonsView = lons;
+	graph.coordinates = coordinates;
+	graph.buildIndexes();
+	return graph;
+}
+
+/**
+ * Points the views at the owned arrays.
+*/
+void CSRGraph::attach()
+{
+	vertexCount = (int)ids.size();
+	edgeCount = neighbors.size();
+	idsView = ids.data();
+	offsetsView = offsets.data();
+	neighborsView = neighbors.data();
+	weightsView = weights.data();
+	latsView = lats.data();
+	lonsView = lons.data();
+}
+
+/**
+ * Fills the table from original ids to dense indexes.
+ * @note Complexity: O(V)
+*/
+void CSRGraph::buildIndexes()
+{
+	const int *source = ids.empty() ? idsView : ids.data();
+	int count = ids.empty() ? vertexCount : (int)ids.size();
+	for (int i = 0; i < count; i++)
+		indexes.insert(source[i], i);
+}
+
+/**
+ * Fills the offset, neighbor and weight arrays from an edge list.
+ * Edges are stably sorted by origin and then destination,
+ * so that each adjacency range can be binary searched.
+ * @param edges Edge list. It is sorted in place.
+ * @param keepParallel If false, only the last of a run of parallel edges is kept.
+ * @note Complexity: O(V + E log E)
+*/
+void CSRGraph::build(std::vector<CSREdge> &edges, bool keepParallel)
+{
+	std::stable_sort(edges.begin(), edges.end(),
+		[](const CSREdge &a, const CSREdge &b) {
+			return a.orig != b.orig ? a.orig < b.orig : a.dest < b.dest;
+		});
+
+	offsets.assign(ids.size() + 1, 0);
+	neighbors.reserve(edges.size());
+	weights.reserve(edges.size());
+
+	for (size_t i = 0; i < edges.size(); i++)
+	{
+		if (!keepParallel && i + 1 < edges.size()
+			&& edges[i + 1].orig == edges[i].orig && edges[i + 1].dest == edges[i].dest)
+			continue;
+		offsets[edges[i].orig + 1]++;
+		neighbors.push_back(edges[i].dest);
+		weights.push_back(edges[i].weight);
+	}
+
+	for (size_t i = 0; i < ids.size(); i++)
+		offsets[i + 1] += offsets[i];
+}
+
+/**
+ * @return Original id of every dense index.
+ * @note Complexity: O(V)
+*/
+std::vector<int> CSRGraph::getIds() const
+{
+	return std::vector<int>(idsView, idsView + vertexCount);
+}
+
+/**
+ * Finds the dense index of a vertex.
+ * @param id Original vertex id.
+ * @return Dense index, or -1 if there is no such vertex.
+ * @note Complexity: O(1)
+*/
+int CSRGraph::findIndex(int id) const
+{
+	return indexes.find(id);
+}
+
+/**
+ * Finds the weight of the edge between two vertexes.
+ * @param orig Dense index of the origin.
+ * @param dest Dense index of the destination.
+ * @return Weight of the edge, or INF if there is no such edge.
+ * @note Complexity: O(log deg(orig))
+*/
+double CSRGraph::getWeight(int orig, int dest) const
+{
+	const int *first = neighborsView + offsetsView[orig];
+	const int *last = neighborsView + offsetsView[orig + 1];
+	const int *it = std::lower_bound(first, last, dest);
+	if (it == last || *it != dest) return INF;
+	return weightsView[it - neighborsView];
+}
+
+/**
+ * @return Every directed edge of the graph, ordered by origin and destination.
+ * @note Complexity: O(V + E)
+*/
+std::vector<CSREdge> CSRGraph::getEdges() const
+{
+	std::vector<CSREdge> edges;
+	edges.reserve(edgeCount);
+	for (int v = 0; v < vertexCount; v++)
+	{
+		for (size_t e = offsetsView[v]; e < offsetsView[v + 1]; e++)
+			edges.push_back({v, neighborsView[e], weightsView[e]});
+	}
+	return edges;
+}
+
+/**
+ * @return Approximate amount of memory used by the graph, in bytes.
+ * Arrays viewed from elsewhere are not counted.
+*/
+size_t CSRGraph::getMemoryUsage() const
+{
+	return ids.size() * sizeof(int)
+		+ indexes.getMemoryUsage()
+		+ offsets.size() * sizeof(size_t)
+		+ neighbors.size() * sizeof(int)
+		+ weights.size() * sizeof(double)
+		+ (lats.size() + lons.size()) * sizeof(double);
+}
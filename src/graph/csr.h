@@ -0,0 +1,96 @@
+#ifndef CSR_H
+#define CSR_H
+
+#include "graph.h"
+#include <cstddef>
+#include <memory>
+
+/**
+ * Directed weighted edge between two dense vertex indexes.
+*/
+struct CSREdge {
+	int orig;
+	int dest;
+	double weight;
+};
+
+/**
+ * Immutable compressed sparse row (CSR) representation of a graph.
+ * Vertexes are addressed by a dense index in [0, V), following the
+ * order of the vertex set they were built from.
+ * The outgoing edges of vertex v are the contiguous range
+ * [edgeBegin(v), edgeEnd(v)) of the neighbor and weight arrays,
+ * sorted by destination index.
+ * The arrays are either owned by the graph or a view of memory kept alive
+ * by a shared handle, such as a memory-mapped snapshot file.
+*/
+class CSRGraph {
+public:
+	CSRGraph();
+	CSRGraph(const Graph &graph);
+	CSRGraph(const std::vector<int> &ids, const std::vector<CSREdge> &edges,
+		bool bidirectional);
+	CSRGraph(const CSRGraph &other);
+	CSRGraph(CSRGraph &&other) noexcept;
+	CSRGraph &operator=(const CSRGraph &other);
+	CSRGraph &operator=(CSRGraph &&other) noexcept;
+
+	static CSRGraph view(std::shared_ptr<const void> backing, int vertexCount, size_t edgeCount,
+		const int *ids, const size_t *offsets, const int *neighbors, const double *weights,
+		const double *lats, const double *lons, bool coordinates);
+
+	int getNumVertex() const { return vertexCount; }
+	size_t getNumEdges() const { return edgeCount; }
+	bool empty() const { return vertexCount == 0; }
+
+	int getId(int index) const { return idsView[index]; }
+	std::vector<int> getIds() const;
+	int findIndex(int id) const;
+
+	size_t edgeBegin(int index) const { return offsetsView[index]; }
+	size_t edgeEnd(int index) const { return offsetsView[index + 1]; }
+	size_t getDegree(int index) const { return offsetsView[index + 1] - offsetsView[index]; }
+	int getDest(size_t edge) const { return neighborsView[edge]; }
+	double getWeight(size_t edge) const { return weightsView[edge]; }
+
+	bool hasCoordinates() const { return coordinates; }
+	double getLat(int index) const { return latsView[index]; }
+	double getLon(int index) const { return lonsView[index]; }
+
+	const size_t *getOffsets() const { return offsetsView; }
+	const int *getNeighbors() const { return neighborsView; }
+	const double *getWeights() const { return weightsView; }
+	const double *getLats() const { return latsView; }
+	const double *getLons() const { return lonsView; }
+	bool isView() const { return backing != nullptr; }
+
+	double getWeight(int orig, int dest) const;
+	std::vector<CSREdge> getEdges() const;
+	size_t getMemoryUsage() const;
+
+private:
+	std::vector<int> ids;
+	IdIndex indexes;
+	std::vector<size_t> offsets;
+	std::vector<int> neighbors;
+	std::vector<double> weights;
+	std::vector<double> lats;
+	std::vector<double> lons;
+	bool coordinates = false;
+
+	std::shared_ptr<const void> backing;
+	int vertexCount = 0;
+	size_t edgeCount = 0;
+	const int *idsView = nullptr;
+	const size_t *offsetsView = nullptr;
+	const int *neighborsView = nullptr;
+	const double *weightsView = nullptr;
+	const double *latsView = nullptr;
+	const double *lonsView = nullptr;
+
+	void build(std::vector<CSREdge> &edges, bool keepParallel);
+	void attach();
+	void buildIndexes();
+};
+
+#endif
@@ -0,0 +1,80 @@
+#include "distanceCache.h"
+#include <algorithm>
+
+/** Key of an empty slot. No pair of valid indexes produces it. */
+#define EMPTY_KEY UINT64_MAX
+
+/**
+ * Creates an empty cache.
+ * @param slots Number of slots, rounded up to a power of two.
+*/
+DistanceCache::DistanceCache(size_t slots)
+{
+	size_t size = 1;
+	while (size < slots) size <<= 1;
+	this->slots.assign(size, {EMPTY_KEY, 0});
+}
+
+/**
+ * Builds the key of an unordered pair of indexes.
+*/
+uint64_t DistanceCache::makeKey(int orig, int dest)
+{
+	if (orig > dest) std::swap(orig, dest);
+	return ((uint64_t)(uint32_t)orig << 32) | (uint32_t)dest;
+}
+
+/**
+ * Hashes a key into a slot index.
+*/
+size_t DistanceCache::slotOf(uint64_t key) const
+{
+	key ^= key >> 33;
+	key *= 0xff51afd7ed558ccdULL;
+	key ^= key >> 33;
+	return key & (slots.size() - 1);
+}
+
+/**
+ * Looks up the distance between two vertexes.
+ * @param orig Index of the first vertex.
+ * @param dest Index of the second vertex.
+ * @param distance Set to the cached distance, if found.
+ * @return True if the pair was cached.
+ * @note Complexity: O(1)
+*/
+bool DistanceCache::find(int orig, int dest, double &distance) const
+{
+	uint64_t key = makeKey(orig, dest);
+	const Slot &slot = slots[slotOf(key)];
+	if (slot.key != key) return false;
+	distance = slot.distance;
+	return true;
+}
+
+/**
+ * Caches the distance between two vertexes, evicting the pair that shared its slot.
+ * @note Complexity: O(1)
+*/
+void DistanceCache::insert(int orig, int dest, double distance)
+{
+	uint64_t key = makeKey(orig, dest);
+	slots[slotOf(key)] = {key, distance};
+}
+
+/**
+ * Empties the cache, keeping its size.
+ * @note Complexity: O(S), S being the number of slots.
+*/
+void DistanceCache::clear()
+{
+	std::fill(slots.begin(), slots.end(), Slot{EMPTY_KEY, 0});
+}
+
+/**
+ * @return Amount of memory used by the cache, in bytes.
+*/
+size_t DistanceCache::getMemoryUsage() const
+{
+	return slots.size() * sizeof(Slot);
+}
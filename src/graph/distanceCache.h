@@ -0,0 +1,35 @@
+#ifndef DISTANCE_CACHE_H
+#define DISTANCE_CACHE_H
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+/**
+ * Bounded direct-mapped cache of distances between pairs of vertex indexes.
+ * Each pair maps to a single slot, a new pair simply replaces the previous one.
+ * The pair is unordered: (u, v) and (v, u) share the same slot.
+ * Not thread-safe.
+*/
+class DistanceCache {
+public:
+	DistanceCache(size_t slots = 1 << 18);
+
+	bool find(int orig, int dest, double &distance) const;
+	void insert(int orig, int dest, double distance);
+	void clear();
+	size_t getMemoryUsage() const;
+
+private:
+	struct Slot {
+		uint64_t key;
+		double distance;
+	};
+
+	std::vector<Slot> slots;
+
+	static uint64_t makeKey(int orig, int dest);
+	size_t slotOf(uint64_t key) const;
+};
+
+#endif
@@ -0,0 +1,29 @@
+#include "distanceMatrix.h"
+
+DistanceMatrix::DistanceMatrix() {}
+
+/**
+ * Builds the distance matrix of a graph.
+ * Intended for fully connected graphs, where it replaces the edge lookups.
+ * @param graph Graph to convert.
+ * @note Complexity: O(V^2 + E)
+*/
+DistanceMatrix::DistanceMatrix(const CSRGraph &graph) : n(graph.getNumVertex())
+{
+	data.assign((size_t)n * n, INF);
+	for (int u = 0; u < n; u++)
+	{
+		double *line = data.data() + (size_t)u * n;
+		line[u] = 0;
+		for (size_t e = graph.edgeBegin(u); e < graph.edgeEnd(u); e++)
+			line[graph.getDest(e)] = graph.getWeight(e);
+	}
+}
+
+/**
+ * @return Amount of memory used by the matrix, in bytes.
+*/
+size_t DistanceMatrix::getMemoryUsage() const
+{
+	return data.size() * sizeof(double);
+}
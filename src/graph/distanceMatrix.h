@@ -0,0 +1,28 @@
+#ifndef DISTANCE_MATRIX_H
+#define DISTANCE_MATRIX_H
+
+#include "csr.h"
+
+/**
+ * Dense row-major matrix with the distance between every pair of vertexes,
+ * indexed by the dense vertex indexes of a CSR graph.
+ * Missing edges are stored as INF and the diagonal as 0.
+*/
+class DistanceMatrix {
+public:
+	DistanceMatrix();
+	DistanceMatrix(const CSRGraph &graph);
+
+	int size() const { return n; }
+	bool empty() const { return n == 0; }
+	double get(int orig, int dest) const { return data[(size_t)orig * n + dest]; }
+	const double *row(int orig) const { return data.data() + (size_t)orig * n; }
+
+	size_t getMemoryUsage() const;
+
+private:
+	int n = 0;
+	std::vector<double> data;
+};
+
+#endif
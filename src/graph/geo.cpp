@@ -0,0 +1,162 @@
+#include "geo.h"
+#include <cmath>
+#include <algorithm>
+
+#if defined(__GNUC__) && !defined(__clang__) && defined(__linux__) && defined(__x86_64__)
+# define GEO_KERNEL __attribute__((target_clones("avx512f", "avx2", "default")))
+#else
+# define GEO_KERNEL
+#endif
+
+/** Coefficients of the asin rational approximation (fdlibm). */
+#define PS0  1.66666666666666657415e-01
+#define PS1 -3.25565818622400915405e-01
+#define PS2  2.01212532134862925881e-01
+#define PS3 -4.00555345006794114027e-02
+#define PS4  7.91534994289814532176e-04
+#define PS5  3.47933107596021167570e-05
+#define QS1 -2.40339491173441421878e+00
+#define QS2  2.02094576023350569471e+00
+#define QS3 -6.88283971605453293030e-01
+#define QS4  7.70381505559019352791e-02
+#define PI_2 1.57079632679489661923
+
+/**
+ * Branch-free arc sine for x in [0, 1], so that loops calling it can be vectorized.
+ * Uses asin(x) = x + x R(x^2) below 0.5 and asin(x) = pi/2 - 2 asin(sqrt((1 - x) / 2)) above.
+*/
+static inline double asinUnit(double x)
+{
+	bool large = x >= 0.5;
+	double half = (1.0 - x) * 0.5;
+	double root = std::sqrt(half);
+	double z = large ? half : x * x;
+	double s = large ? root : x;
+	double p = z * (PS0 + z * (PS1 + z * (PS2 + z * (PS3 + z * (PS4 + z * PS5)))));
+	double q = 1.0 + z * (QS1 + z * (QS2 + z * (QS3 + z * QS4)));
+	double r = s + s * (p / q);
+	double reflected = PI_2 - 2.0 * r;
+	return large ? reflected : r;
+}
+
+/**
+ * Haversine distance from the precomputed trigonometry of two points.
+ * Rounding may push the haversine slightly outside [0, 1], so it is clamped.
+*/
+static inline double haversine(double sinLat1, double cosLat1, double sinLon1, double cosLon1,
+	double sinLat2, double cosLat2, double sinLon2, double cosLon2)
+{
+	double cosLats = cosLat1 * cosLat2;
+	double havLat = (1.0 - (cosLats + sinLat1 * sinLat2)) * 0.5;
+	double havLon = (1.0 - (cosLon1 * cosLon2 + sinLon1 * sinLon2)) * 0.5;
+	double a = havLat + cosLats * havLon;
+	a = std::min(std::max(a, 0.0), 1.0);
+	return 2.0 * EARTH_RADIUS * asinUnit(std::sqrt(a));
+}
+
+GeoTable::GeoTable() {}
+
+/**
+ * Precomputes the trigonometry of the coordinates of every vertex.
+ * @param graph Graph whose vertexes all have coordinates.
+ * @note Complexity: O(V)
+*/
+GeoTable::GeoTable(const CSRGraph &graph)
+{
+	int n = graph.getNumVertex();
+	sinLat.resize(n);
+	cosLat.resize(n);
+	sinLon.resize(n);
+	cosLon.resize(n);
+	for (int i = 0; i < n; i++)
+	{
+		double lat = graph.getLat(i) * PI / 180.0;
+		double lon = graph.getLon(i) * PI / 180.0;
+		sinLat[i] = std::sin(lat);
+		cosLat[i] = std::cos(lat);
+		sinLon[i] = std::sin(lon);
+		cosLon[i] = std::cos(lon);
+	}
+}
+
+/**
+ * Haversine distance between two vertexes.
+ * Gives exactly the same result as the row kernels.
+ * @param orig Index of the first vertex.
+ * @param dest Index of the second vertex.
+ * @note Complexity: O(1)
+*/
+double GeoTable::distance(int orig, int dest) const
+{
+	return haversine(sinLat[orig], cosLat[orig], sinLon[orig], cosLon[orig],
+		sinLat[dest], cosLat[dest], sinLon[dest], cosLon[dest]);
+}
+
+/**
+ * Computes the haversine distance from a vertex to each vertex of an index range.
+ * @param orig Index of the origin.
+ * @param begin First destination index.
+ * @param end One past the last destination index.
+ * @param out Filled with the distance to begin + k at out[k].
+ * @note Complexity: O(end - begin)
+*/
+GEO_KERNEL
+void GeoTable::distanceRow(int orig, int begin, int end, double *out) const
+{
+	const double sla = sinLat[orig], cla = cosLat[orig];
+	const double slo = sinLon[orig], clo = cosLon[orig];
+	const double *__restrict sinLatDest = sinLat.data() + begin;
+	const double *__restrict cosLatDest = cosLat.data() + begin;
+	const double *__restrict sinLonDest = sinLon.data() + begin;
+	const double *__restrict cosLonDest = cosLon.data() + begin;
+	double *__restrict dist = out;
+
+	for (int k = 0; k < end - begin; k++)
+		dist[k] = haversine(sla, cla, slo, clo,
+			sinLatDest[k], cosLatDest[k], sinLonDest[k], cosLonDest[k]);
+}
+
+/**
+ * Computes the haversine distance from a vertex to an arbitrary list of vertexes.
+ * Destinations are gathered in blocks, so that the distances themselves
+ * are computed by the same vectorized loop as in distanceRow.
+ * @param orig Index of the origin.
+ * @param dests Indexes of the destinations.
+ * @param count Number of destinations.
+ * @param out Filled with the distance to dests[k] at out[k].
+ * @note Complexity: O(count)
+*/
+GEO_KERNEL
+void GeoTable::distanceTo(int orig, const int *dests, int count, double *out) const
+{
+	const int BLOCK = 64;
+	const double sla = sinLat[orig], cla = cosLat[orig];
+	const double slo = sinLon[orig], clo = cosLon[orig];
+	double sinLatDest[BLOCK], cosLatDest[BLOCK], sinLonDest[BLOCK], cosLonDest[BLOCK];
+
+	for (int first = 0; first < count; first += BLOCK)
+	{
+		int size = std::min(BLOCK, count - first);
+		for (int k = 0; k < size; k++)
+		{
+			int d = dests[first + k];
+			sinLatDest[k] = sinLat[d];
+			cosLatDest[k] = cosLat[d];
+			sinLonDest[k] = sinLon[d];
+			cosLonDest[k] = cosLon[d];
+		}
+
+		double *__restrict dist = out + first;
+		for (int k = 0; k < size; k++)
+			dist[k] = haversine(sla, cla, slo, clo,
+				sinLatDest[k], cosLatDest[k], sinLonDest[k], cosLonDest[k]);
+	}
+}
+
+/**
+ * @return Amount of memory used by the table, in bytes.
+*/
+size_t GeoTable::getMemoryUsage() const
+{
+	return 4 * sinLat.size() * sizeof(double);
+}
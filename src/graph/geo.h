@@ -0,0 +1,41 @@
+#ifndef GEO_H
+#define GEO_H
+
+#include "csr.h"
+
+#define PI 3.14159265
+#define EARTH_RADIUS 6371000
+
+/**
+ * Structure-of-arrays table with the precomputed trigonometry 
+ * of the coordinates of every vertex, indexed like the CSR graph it was built from.
+ * With it, the haversine distance between two vertexes needs no sin/cos/atan2 calls:
+ *   hav(dlat) = (1 - (cosLat1 cosLat2 + sinLat1 sinLat2)) / 2
+ *   hav(dlon) = (1 - (cosLon1 cosLon2 + sinLon1 sinLon2)) / 2
+ *   a = hav(dlat) + cosLat1 cosLat2 hav(dlon)
+ *   distance = 2 R asin(sqrt(a))
+ * The one-to-many kernel computes a whole row of distances at once 
+ * and is compiled for AVX-512, AVX2 and a scalar fallback, selected at runtime.
+*/
+class GeoTable {
+public:
+	GeoTable();
+	GeoTable(const CSRGraph &graph);
+
+	int size() const { return (int)sinLat.size(); }
+	bool empty() const { return sinLat.empty(); }
+
+	double distance(int orig, int dest) const;
+	void distanceRow(int orig, int begin, int end, double *out) const;
+	void distanceTo(int orig, const int *dests, int count, double *out) const;
+
+	size_t getMemoryUsage() const;
+
+private:
+	std::vector<double> sinLat;
+	std::vector<double> cosLat;
+	std::vector<double> sinLon;
+	std::vector<double> cosLon;
+};
+
+#endif
@@ -21,21 +21,35 @@ std::string Info::toStr() {
 
 /************************* Vertex **************************/
 
-Vertex::Vertex(int id) : id(id) {}
-Vertex::Vertex(int id, Info info) : id(id), info(info) {}
+Vertex::Vertex(int id, std::pmr::memory_resource *resource)
+	: id(id), resource(resource), adj(resource), adjMap(resource), incoming(resource) {}
+Vertex::Vertex(int id, Info info, std::pmr::memory_resource *resource)
+	: id(id), info(info), resource(resource), adj(resource), adjMap(resource), incoming(resource) {}
 
 /*
  * Auxiliary function to add an outgoing edge to a vertex (this),
  * with a given destination vertex (d) and edge weight (w).
+ * The edge is allocated from the vertex's memory resource.
 */
 Edge *Vertex::addEdge(Vertex *d, double w) {
-    auto newEdge = new Edge(this, d, w);
+    auto newEdge = new (resource->allocate(sizeof(Edge), alignof(Edge))) Edge(this, d, w);
     adj.push_back(newEdge);
 	adjMap[d->getId()] = newEdge;
 	d->incoming.push_back(newEdge);
     return newEdge;
 }
 
+/*
+ * Makes room for a number of outgoing and incoming edges.
+ * The containers come from a monotonic arena, which never reuses the blocks
+ * a growing container leaves behind, so callers adding many edges reserve them first.
+*/
+void Vertex::reserveEdges(size_t degree) {
+	adj.reserve(degree);
+	adjMap.reserve(degree);
+	incoming.reserve(degree);
+}
+
 /*
  * Auxiliary function to remove an outgoing edge (with a given destination (d))
  * from a vertex (this).
@@ -74,18 +88,8 @@ void Vertex::removeOutgoingEdges() {
 }
 
 Edge *Vertex::getEdgeTo(Vertex *dest) const {
-	try
-	{
-		return adjMap.at(dest->id);
-	}
-	catch (const std::exception& e)
-	{
-		return nullptr;
-	}
-}
-
-bool Vertex::operator<(Vertex & vertex) const {
-    return this->dist < vertex.dist;
+	auto it = adjMap.find(dest->id);
+	return it == adjMap.end() ? nullptr : it->second;
 }
 
 int Vertex::getId() const {
@@ -96,40 +100,15 @@ Info Vertex::getInfo() const {
     return this->info;
 }
 
-const std::vector<Edge *>& Vertex::getAdj() const {
+const std::pmr::vector<Edge *>& Vertex::getAdj() const {
     return this->adj;
 }
 
-std::unordered_map<int, Edge *> Vertex::getAdjMap() const {
+const std::pmr::unordered_map<int, Edge *>& Vertex::getAdjMap() const {
     return this->adjMap;
 }
 
-void Vertex::clearAdj() {
-	this->adj.clear();
-	this->adjMap.clear();
-}
-
-bool Vertex::isVisited() const {
-    return this->visited;
-}
-
-bool Vertex::isProcessing() const {
-    return this->processing;
-}
-
-unsigned int Vertex::getIndegree() const {
-    return this->indegree;
-}
-
-double Vertex::getDist() const {
-    return this->dist;
-}
-
-Edge *Vertex::getPath() const {
-    return this->path;
-}
-
-std::vector<Edge *> Vertex::getIncoming() const {
+const std::pmr::vector<Edge *>& Vertex::getIncoming() const {
     return this->incoming;
 }
 
@@ -141,26 +120,6 @@ void Vertex::setInfo(Info info) {
     this->info = info;
 }
 
-void Vertex::setVisited(bool visited) {
-    this->visited = visited;
-}
-
-void Vertex::setProcesssing(bool processing) {
-    this->processing = processing;
-}
-
-void Vertex::setIndegree(unsigned int indegree) {
-    this->indegree = indegree;
-}
-
-void Vertex::setDist(double dist) {
-    this->dist = dist;
-}
-
-void Vertex::setPath(Edge *path) {
-    this->path = path;
-}
-
 void Vertex::deleteEdge(Edge *edge) {
     Vertex *dest = edge->getDest();
     // Remove the corresponding edge from the incoming list
@@ -173,7 +132,8 @@ void Vertex::deleteEdge(Edge *edge) {
             it++;
         }
     }
-    delete edge;
+    edge->~Edge();
+    resource->deallocate(edge, sizeof(Edge), alignof(Edge));
 }
 
 /********************** Edge  ****************************/
@@ -223,7 +183,35 @@ void Edge::setFlow(double flow) {
 
 /********************** Graph  ****************************/
 
-Graph::~Graph() {}
+Graph::Graph() : arena(std::make_unique<std::pmr::monotonic_buffer_resource>(1 << 20)) {}
+
+/**
+ * Takes the vertexes and the arena of another graph, which is left empty.
+*/
+Graph::Graph(Graph &&other) : Graph() {
+	*this = std::move(other);
+}
+
+/**
+ * Releases this graph and takes the vertexes and the arena of another one,
+ * which is left empty.
+ * @note Complexity: O(V)
+*/
+Graph &Graph::operator=(Graph &&other) {
+	if (this == &other) return *this;
+	resetGraph();
+	std::swap(vertexSet, other.vertexSet);
+	std::swap(vertexIndex, other.vertexIndex);
+	std::swap(arena, other.arena);
+	return *this;
+}
+
+/**
+ * Destroys the vertexes and releases the arena.
+*/
+Graph::~Graph() {
+	resetGraph();
+}
 
 int Graph::getNumVertex() const {
     return vertexSet.size();
@@ -233,25 +221,23 @@ const std::vector<Vertex *>& Graph::getVertexSet()  const{
     return vertexSet;
 }
 
-const std::unordered_map<int, Vertex*>& Graph::getVertexMap() const {
-    return vertexMap;
+/**
+ * Finds the position of a vertex in the vertex set.
+ * @param id Vertex id.
+ * @return Index in the vertex set, or -1 if there is no such vertex.
+ * @note Complexity: O(1)
+*/
+int Graph::findIndex(int id) const {
+	return vertexIndex.find(id);
 }
 
 /*
  * Auxiliary function to find a vertex with a given content.
+ * Returns nullptr if there is no such vertex.
  */
 Vertex *Graph::findVertex(int id) const {
-	try
-	{
-		return vertexMap.at(id);
-	}
-	catch(const std::exception& e)
-	{
-		for (auto v : vertexSet)
-        	if (v->getId() == id)
-           		return v;
-    	return nullptr;
-	}
+	int index = vertexIndex.find(id);
+	return index == -1 ? nullptr : vertexSet[index];
 }
 
 /*
@@ -259,11 +245,11 @@ Vertex *Graph::findVertex(int id) const {
  *  Returns true if successful, and false if a vertex with that content already exists.
  */
 bool Graph::addVertex(int id, Info info) {
-	if (findVertex(id) != nullptr)
+	if (vertexIndex.contains(id))
     	return false;
 	
-	Vertex *vtx = new Vertex(id, info);
-	vertexMap[id] = vtx;
+	Vertex *vtx = new (arena->allocate(sizeof(Vertex), alignof(Vertex))) Vertex(id, info, arena.get());
+	vertexIndex.insert(id, vertexSet.size());
 	vertexSet.push_back(vtx);
 	return true;
 }
@@ -280,9 +266,12 @@ bool Graph::removeVertex(int id) {
             v->removeOutgoingEdges();
             for (auto u : vertexSet)
                 u->removeEdge(id);
-			vertexMap.erase(id);
-            vertexSet.erase(it);
-            delete v;
+            it = vertexSet.erase(it);
+			vertexIndex.erase(id);
+			for (; it != vertexSet.end(); it++)
+				vertexIndex.insert((*it)->getId(), it - vertexSet.begin());
+            v->~Vertex();
+            arena->deallocate(v, sizeof(Vertex), alignof(Vertex));
             return true;
         }
     }
@@ -330,14 +319,33 @@ bool Graph::addBidirectionalEdge(int sourc, int dest, double w) {
 
 /**
  * Erases all vertexes and edges from the graph.
- * @note Complexity: O(V + E)
+ * Vertexes, edges and their containers all live in the arena,
+ * so their destructors are not run: the arena is returned in a few large blocks.
+ * Only the vertex labels, which may own heap memory, are released beforehand.
+ * Memory of removed vertexes and edges is also only reclaimed here.
+ * @note Complexity: O(V)
 */
 void Graph::resetGraph() {
-	for (auto v : vertexSet) {
-		for (auto e : v->getAdj())
-			delete e;
-		delete v;
-	}
+	for (auto v : vertexSet)
+		v->setInfo(Info());
 	vertexSet.clear();
-	vertexMap.clear();
+	vertexIndex.clear();
+	arena->release();
+}
+
+/**
+ * @return Approximate amount of memory used by the vertexes, edges and their containers, in bytes.
+ * @note Complexity: O(V)
+*/
+size_t Graph::getMemoryUsage() const {
+	size_t bytes = vertexSet.capacity() * sizeof(Vertex *) + vertexIndex.getMemoryUsage();
+	for (auto v : vertexSet)
+	{
+		bytes += sizeof(Vertex) + v->getInfo().label.size()
+			+ (v->getAdj().capacity() + v->getIncoming().capacity()) * sizeof(Edge *)
+			+ v->getAdj().size() * sizeof(Edge)
+			+ v->getAdjMap().size() * (sizeof(std::pair<const int, Edge *>) + 2 * sizeof(void *))
+			+ v->getAdjMap().bucket_count() * sizeof(void *);
+	}
+	return bytes;
 }
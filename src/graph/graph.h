@@ -9,6 +9,9 @@
 #include <unordered_map>
 #include <string>
 #include <sstream>
+#include <memory_resource>
+#include <memory>
+#include "idIndex.h"
 
 class Edge;
 class Vertex;
@@ -32,51 +35,41 @@ public:
 
 /************************* Vertex  **************************/
 
+/**
+ * Vertexes only hold the loaded data.
+ * The working state of the algorithms (visited flags, distances, paths)
+ * is kept by each run in arrays indexed by the CSR vertex indexes,
+ * so the graph is never changed while solving.
+*/
 class Vertex {
 public:
-    Vertex(int id);
-	Vertex(int id, Info info);
-    bool operator<(Vertex& vertex) const;
+    Vertex(int id, std::pmr::memory_resource *resource = std::pmr::get_default_resource());
+	Vertex(int id, Info info, std::pmr::memory_resource *resource = std::pmr::get_default_resource());
 
 	int getId() const;
     Info getInfo() const;
-    const std::vector<Edge *>& getAdj() const;
-	std::unordered_map<int, Edge *> getAdjMap() const;
+    const std::pmr::vector<Edge *>& getAdj() const;
+	const std::pmr::unordered_map<int, Edge *>& getAdjMap() const;
 
-    bool isVisited() const;
-    bool isProcessing() const;
-    unsigned int getIndegree() const;
-    double getDist() const;
-    Edge *getPath() const;
-    std::vector<Edge *> getIncoming() const;
+    const std::pmr::vector<Edge *>& getIncoming() const;
 
     void setId(int id);
 	void setInfo(Info info);
-    void setVisited(bool visited);
-    void setProcesssing(bool processing);
-    void setIndegree(unsigned int indegree);
-    void setDist(double dist);
-    void setPath(Edge *path);
     Edge *addEdge(Vertex *dest, double w);
+	void reserveEdges(size_t degree);
     bool removeEdge(int id);
     void removeOutgoingEdges();
-	void clearAdj();
 
 	Edge *getEdgeTo(Vertex *dest) const;
 	
 protected:
 	int id;
     Info info;
-    std::vector<Edge *> adj;
-	std::unordered_map<int, Edge *> adjMap;
+	std::pmr::memory_resource *resource;
+    std::pmr::vector<Edge *> adj;
+	std::pmr::unordered_map<int, Edge *> adjMap;
 
-    bool visited = false;
-    bool processing = false;
-    unsigned int indegree;
-    double dist = 0;
-    Edge *path = nullptr;
-
-    std::vector<Edge *> incoming;
+    std::pmr::vector<Edge *> incoming;
 
     void deleteEdge(Edge *edge);
 };
@@ -113,11 +106,22 @@ protected:
 
 /********************** Graph  ****************************/
 
+/**
+ * Vertexes, edges and their adjacency containers are allocated
+ * from an arena owned by the graph, which is released as a whole on reset.
+ * The arena lives on the heap, so moving a graph keeps its vertexes in place.
+*/
 class Graph {
 public:
+    Graph();
     ~Graph();
+    Graph(const Graph &) = delete;
+    Graph &operator=(const Graph &) = delete;
+    Graph(Graph &&other);
+    Graph &operator=(Graph &&other);
 
     Vertex *findVertex(int in) const;
+    int findIndex(int in) const;
     bool addVertex(int in, Info info);
     bool removeVertex(int in);
 
@@ -127,11 +131,12 @@ public:
 
     int getNumVertex() const;
     const std::vector<Vertex *>& getVertexSet() const;
-    const std::unordered_map<int, Vertex*>& getVertexMap() const;
 	void resetGraph();
+	size_t getMemoryUsage() const;
 protected:
     std::vector<Vertex *> vertexSet;
-	std::unordered_map<int, Vertex *> vertexMap;
+	IdIndex vertexIndex;
+	std::unique_ptr<std::pmr::monotonic_buffer_resource> arena;
 };
 
 #endif
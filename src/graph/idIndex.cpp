@@ -0,0 +1,96 @@
+#include "idIndex.h"
+#include <algorithm>
+
+IdIndex::IdIndex() {}
+
+/**
+ * Sets the index of an id, replacing any previous one.
+ * @param id Vertex id.
+ * @param index Dense index, not negative.
+ * @note Complexity: O(1) amortized
+*/
+void IdIndex::insert(int id, int index)
+{
+	if (!dense)
+	{
+		count += sparse.insert_or_assign(id, index).second;
+		return;
+	}
+
+	if (table.empty()) base = id;
+	int64_t first = std::min<int64_t>(base, id);
+	int64_t last = std::max<int64_t>(base + (int64_t)table.size(), (int64_t)id + 1);
+	if (last - first > std::max(MIN_SLOTS, MAX_SLOTS_PER_ID * (int64_t)(count + 1)))
+	{
+		toSparse();
+		insert(id, index);
+		return;
+	}
+
+	if (id < base)
+	{
+		// Grow to the left with room to spare, so that descending ids are amortized
+		int64_t grow = std::max<int64_t>(base - id, (int64_t)table.size() / 2);
+		grow = std::min(grow, base - (int64_t)INT32_MIN);
+		table.insert(table.begin(), grow, -1);
+		base -= grow;
+	}
+	else if (id - base >= (int64_t)table.size()) table.resize(id - base + 1, -1);
+
+	int &slot = table[id - base];
+	if (slot == -1) count++;
+	slot = index;
+}
+
+/**
+ * Removes an id.
+ * @param id Vertex id.
+ * @note Complexity: O(1)
+*/
+void IdIndex::erase(int id)
+{
+	if (!dense)
+	{
+		count -= sparse.erase(id);
+		return;
+	}
+	uint64_t slot = (uint64_t)((int64_t)id - base);
+	if (slot >= table.size() || table[slot] == -1) return;
+	table[slot] = -1;
+	count--;
+}
+
+/**
+ * Removes every id and goes back to the table representation.
+ * @note Complexity: O(1) for the table, O(n) for the hash map
+*/
+void IdIndex::clear()
+{
+	dense = true;
+	base = 0;
+	count = 0;
+	table.clear();
+	sparse.clear();
+}
+
+/**
+ * Moves the ids from the table to the hash map.
+ * @note Complexity: O(table size)
+*/
+void IdIndex::toSparse()
+{
+	sparse.reserve(count);
+	for (size_t slot = 0; slot < table.size(); slot++)
+		if (table[slot] != -1) sparse[(int)(base + (int64_t)slot)] = table[slot];
+	std::vector<int>().swap(table);
+	dense = false;
+}
+
+/**
+ * @return Approximate amount of memory used by the index, in bytes.
+*/
+size_t IdIndex::getMemoryUsage() const
+{
+	return table.capacity() * sizeof(int) 
+		+ sparse.size() * (sizeof(std::pair<int, int>) + 2 * sizeof(void *));
+}
@@ -0,0 +1,59 @@
+#ifndef ID_INDEX_H
+#define ID_INDEX_H
+
+#include <vector>
+#include <unordered_map>
+#include <cstdint>
+#include <cstddef>
+
+/**
+ * Maps vertex ids to dense indexes, without exceptions.
+ * While the ids are reasonably dense (as the 0..V-1 ids of every dataset),
+ * the index of id is kept in a table at position (id - base), giving
+ * O(1) lookups with a single array access. If the ids become too sparse 
+ * for the table, it switches to a hash map.
+*/
+class IdIndex {
+public:
+	IdIndex();
+
+	/**
+	 * @return Index of the id, or -1 if it was not inserted.
+	*/
+	int find(int id) const
+	{
+		if (!dense)
+		{
+			auto it = sparse.find(id);
+			return it == sparse.end() ? -1 : it->second;
+		}
+		uint64_t slot = (uint64_t)((int64_t)id - base);
+		return slot < table.size() ? table[slot] : -1;
+	}
+
+	bool contains(int id) const { return find(id) != -1; }
+	size_t size() const { return count; }
+	bool isDense() const { return dense; }
+
+	void insert(int id, int index);
+	void erase(int id);
+	void clear();
+	size_t getMemoryUsage() const;
+
+private:
+	/** Table slots allowed per id inserted, before switching to a hash map. */
+	static const int64_t MAX_SLOTS_PER_ID = 4;
+
+	/** Table slots always allowed, whatever the number of ids. */
+	static const int64_t MIN_SLOTS = 1024;
+
+	bool dense = true;
+	int64_t base = 0;
+	size_t count = 0;
+	std::vector<int> table;
+	std::unordered_map<int, int> sparse;
+
+	void toSparse();
+};
+
+#endif
@@ -0,0 +1,109 @@
+#ifndef INDEXED_HEAP_H
+#define INDEXED_HEAP_H
+
+#include <vector>
+
+/**
+ * Min-heap of the indexes 0 to n - 1 with a key each, with decrease-key.
+ * The position of every index in the heap is kept, so each index is in the heap
+ * at most once and its key is lowered in place instead of pushing it again.
+ * Indexes are ordered by key, then by index, so ties are broken the same way
+ * as scanning the indexes in increasing order.
+ * Each node has D children: wider nodes make the heap shallower,
+ * so lowering a key (the most frequent operation) moves it through fewer levels.
+*/
+template <int D = 4>
+class IndexedHeap {
+public:
+	/**
+	 * Creates an empty heap for the indexes 0 to n - 1.
+	 * @note Complexity: O(n)
+	*/
+	explicit IndexedHeap(int n) : keys(n), positions(n, -1) { heap.reserve(n); }
+
+	bool empty() const { return heap.empty(); }
+	bool contains(int index) const { return positions[index] != -1; }
+	double key(int index) const { return keys[index]; }
+
+	/**
+	 * Adds an index that is not in the heap, or lowers its key if it is.
+	 * @note Complexity: O(log_D n)
+	*/
+	void push(int index, double key)
+	{
+		if (positions[index] == -1)
+		{
+			positions[index] = heap.size();
+			heap.push_back(index);
+		}
+		keys[index] = key;
+		up(positions[index]);
+	}
+
+	/**
+	 * Removes the index with the smallest key.
+	 * @return The removed index.
+	 * @note Complexity: O(D log_D n)
+	*/
+	int pop()
+	{
+		int top = heap.front();
+		positions[top] = -1;
+		int last = heap.back();
+		heap.pop_back();
+		if (!heap.empty())
+		{
+			heap.front() = last;
+			positions[last] = 0;
+			down(0);
+		}
+		return top;
+	}
+
+private:
+	std::vector<double> keys;
+	std::vector<int> positions;
+	std::vector<int> heap;
+
+	bool before(int a, int b) const
+	{
+		return keys[a] < keys[b] || (keys[a] == keys[b] && a < b);
+	}
+
+	void up(size_t position)
+	{
+		int index = heap[position];
+		while (position > 0)
+		{
+			size_t parent = (position - 1) / D;
+			if (!before(index, heap[parent])) break;
+			heap[position] = heap[parent];
+			positions[heap[position]] = position;
+			position = parent;
+		}
+		heap[position] = index;
+		positions[index] = position;
+	}
+
+	void down(size_t position)
+	{
+		int index = heap[position];
+		while (true)
+		{
+			size_t first = position * D + 1;
+			if (first >= heap.size()) break;
+			size_t last = std::min(first + D, heap.size());
+			size_t best = first;
+			for (size_t child = first + 1; child < last; child++)
+				if (before(heap[child], heap[best])) best = child;
+			if (!before(heap[best], index)) break;
+			heap[position] = heap[best];
+			positions[heap[position]] = position;
+			position = best;
+		}
+		heap[position] = index;
+		positions[index] = position;
+	}
+};
+
+#endif
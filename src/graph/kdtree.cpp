@@ -0,0 +1,193 @@
+#include "kdtree.h"
+#include <cmath>
+#include <numeric>
+
+KDTree::KDTree() {}
+
+/**
+ * Builds the tree over the coordinates of every vertex.
+ * Each range is split at its median, on the axis where its points are most spread.
+ * @param graph Graph whose vertexes all have coordinates.
+ * @note Complexity: O(V log V)
+*/
+KDTree::KDTree(const CSRGraph &graph)
+{
+	int n = graph.getNumVertex();
+	std::vector<Point> byIndex(n);
+	for (int i = 0; i < n; i++)
+	{
+		double lat = graph.getLat(i) * PI / 180.0;
+		double lon = graph.getLon(i) * PI / 180.0;
+		byIndex[i] = {{std::cos(lat) * std::cos(lon), std::cos(lat) * std::sin(lon), std::sin(lat)}};
+	}
+
+	points = byIndex;
+	order.resize(n);
+	std::iota(order.begin(), order.end(), 0);
+	axis.assign(n, 0);
+	build(0, n);
+
+	// Keep the points in tree order, so that a search reads them sequentially
+	position.resize(n);
+	for (int p = 0; p < n; p++)
+	{
+		points[p] = byIndex[order[p]];
+		position[order[p]] = p;
+	}
+}
+
+/**
+ * Recursively splits a range of the vertex order.
+ * While building, points are still indexed by vertex.
+ * @note Complexity: O(n log n), n = hi - lo
+*/
+void KDTree::build(int lo, int hi)
+{
+	if (hi - lo <= LEAF_SIZE) return;
+
+	double low[3] = {INF, INF, INF};
+	double high[3] = {-INF, -INF, -INF};
+	for (int p = lo; p < hi; p++)
+	{
+		for (int a = 0; a < 3; a++)
+		{
+			low[a] = std::min(low[a], points[order[p]].x[a]);
+			high[a] = std::max(high[a], points[order[p]].x[a]);
+		}
+	}
+
+	int a = 0;
+	for (int b = 1; b < 3; b++)
+		if (high[b] - low[b] > high[a] - low[a]) a = b;
+
+	int mid = (lo + hi) / 2;
+	std::nth_element(order.begin() + lo, order.begin() + mid, order.begin() + hi,
+		[&](int u, int v) { return points[u].x[a] < points[v].x[a]; });
+	axis[mid] = a;
+
+	build(lo, mid);
+	build(mid + 1, hi);
+}
+
+/**
+ * Finds the k vertexes closest to a vertex.
+ * @param index Dense index of the vertex.
+ * @param k Number of neighbors wanted.
+ * @param out Filled with the indexes of the neighbors, closest first.
+ * Must have room for k values.
+ * @return Number of neighbors found, min(k, V - 1).
+ * @note Complexity: O(k log k + log V) on average
+*/
+int KDTree::nearest(int index, int k, int *out) const
+{
+	std::vector<std::pair<double, int>> heap;
+	heap.reserve(k + 1);
+	if (k > 0) nearest(0, size(), points[position[index]], index, k, heap);
+
+	std::sort_heap(heap.begin(), heap.end());
+	for (size_t i = 0; i < heap.size(); i++)
+		out[i] = heap[i].second;
+	return (int)heap.size();
+}
+
+/**
+ * Searches a range, keeping the k closest points found in a max-heap 
+ * of (squared chord, vertex index) pairs.
+*/
+void KDTree::nearest(int lo, int hi, const Point &query, int self, int k,
+	std::vector<std::pair<double, int>> &heap) const
+{
+	auto consider = [&](int p) {
+		if (order[p] == self) return;
+		double d = squaredChord(query, points[p]);
+		if ((int)heap.size() == k)
+		{
+			if (d >= heap.front().first) return;
+			std::pop_heap(heap.begin(), heap.end());
+			heap.pop_back();
+		}
+		heap.push_back({d, order[p]});
+		std::push_heap(heap.begin(), heap.end());
+	};
+
+	if (hi - lo <= LEAF_SIZE)
+	{
+		for (int p = lo; p < hi; p++)
+			consider(p);
+		return;
+	}
+
+	int mid = (lo + hi) / 2;
+	double diff = query.x[axis[mid]] - points[mid].x[axis[mid]];
+	consider(mid);
+
+	if (diff < 0) nearest(lo, mid, query, self, k, heap);
+	else nearest(mid + 1, hi, query, self, k, heap);
+
+	if ((int)heap.size() < k || diff * diff < heap.front().first)
+	{
+		if (diff < 0) nearest(mid + 1, hi, query, self, k, heap);
+		else nearest(lo, mid, query, self, k, heap);
+	}
+}
+
+/**
+ * Finds the vertexes within a great-circle distance of a vertex.
+ * The search radius is slightly enlarged, so rounding never leaves out a vertex
+ * whose haversine distance is within (radius): callers needing an exact bound
+ * should check the distance of each vertex found.
+ * @param index Dense index of the vertex.
+ * @param radius Distance, in meters.
+ * @param out Filled with the indexes of the vertexes found, in no particular order.
+ * @note Complexity: O(sqrt(V) + m) on average, m being the number of vertexes found
+*/
+void KDTree::withinRadius(int index, double radius, std::vector<int> &out) const
+{
+	out.clear();
+	if (empty() || radius < 0) return;
+
+	double angle = std::min(radius / EARTH_RADIUS, PI);
+	double chord = 2.0 * std::sin(angle / 2.0) * (1.0 + 1e-9) + 1e-12;
+	withinRadius(0, size(), points[position[index]], index, chord * chord, out);
+}
+
+/**
+ * Searches a range for the points within a squared chord distance.
+*/
+void KDTree::withinRadius(int lo, int hi, const Point &query, int self, double chord,
+	std::vector<int> &out) const
+{
+	if (hi - lo <= LEAF_SIZE)
+	{
+		for (int p = lo; p < hi; p++)
+			if (order[p] != self && squaredChord(query, points[p]) <= chord) out.push_back(order[p]);
+		return;
+	}
+
+	int mid = (lo + hi) / 2;
+	double diff = query.x[axis[mid]] - points[mid].x[axis[mid]];
+	if (order[mid] != self && squaredChord(query, points[mid]) <= chord) out.push_back(order[mid]);
+
+	if (diff < 0 || diff * diff <= chord) withinRadius(lo, mid, query, self, chord, out);
+	if (diff >= 0 || diff * diff <= chord) withinRadius(mid + 1, hi, query, self, chord, out);
+}
+
+/**
+ * @return Squared straight-line distance between two points of the unit sphere.
+*/
+double KDTree::squaredChord(const Point &a, const Point &b)
+{
+	double dx = a.x[0] - b.x[0];
+	double dy = a.x[1] - b.x[1];
+	double dz = a.x[2] - b.x[2];
+	return dx * dx + dy * dy + dz * dz;
+}
+
+/**
+ * @return Amount of memory used by the tree, in bytes.
+*/
+size_t KDTree::getMemoryUsage() const
+{
+	return points.size() * sizeof(Point) + (order.size() + position.size()) * sizeof(int)
+		+ axis.size();
+}
@@ -0,0 +1,51 @@
+#ifndef KDTREE_H
+#define KDTREE_H
+
+#include "geo.h"
+
+/**
+ * Spatial index over the coordinates of the vertexes of a CSR graph.
+ * Each vertex is placed on the unit sphere (x, y, z), where the straight-line
+ * (chord) distance grows with the great-circle distance, so the nearest vertexes
+ * by chord are also the nearest by haversine distance.
+ * The tree is implicit: the subtree of a range [lo, hi) of the point array 
+ * has its splitting point at the middle of the range, with smaller coordinates
+ * on the splitting axis to its left.
+ * Queries never return the vertex they are made from.
+*/
+class KDTree {
+public:
+	KDTree();
+	KDTree(const CSRGraph &graph);
+
+	int size() const { return (int)order.size(); }
+	bool empty() const { return order.empty(); }
+
+	int nearest(int index, int k, int *out) const;
+	void withinRadius(int index, double radius, std::vector<int> &out) const;
+
+	size_t getMemoryUsage() const;
+
+private:
+	/** Maximum size of a range searched point by point. */
+	static const int LEAF_SIZE = 8;
+
+	struct Point {
+		double x[3];
+	};
+
+	std::vector<Point> points;
+	std::vector<int> order;
+	std::vector<int> position;
+	std::vector<unsigned char> axis;
+
+	void build(int lo, int hi);
+	void nearest(int lo, int hi, const Point &query, int self, int k,
+		std::vector<std::pair<double, int>> &heap) const;
+	void withinRadius(int lo, int hi, const Point &query, int self, double chord,
+		std::vector<int> &out) const;
+
+	static double squaredChord(const Point &a, const Point &b);
+};
+
+#endif
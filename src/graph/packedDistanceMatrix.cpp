@@ -0,0 +1,58 @@
+#include "packedDistanceMatrix.h"
+
+PackedDistanceMatrix::PackedDistanceMatrix() {}
+
+/**
+ * Allocates the matrix of n vertexes. Rows are filled with fillRow.
+ * @param n Number of vertexes.
+ * @note Complexity: O(n^2)
+*/
+PackedDistanceMatrix::PackedDistanceMatrix(int n) : n(n), owned(pairCount(n))
+{
+	values = owned.data();
+}
+
+/**
+ * Creates a matrix over values it does not own.
+ * @param backing Handle keeping the values alive for as long as the matrix (or a copy) exists.
+ * @param n Number of vertexes.
+ * @param values The n (n - 1) / 2 packed values.
+*/
+PackedDistanceMatrix PackedDistanceMatrix::view(std::shared_ptr<const void> backing, int n, 
+	const float *values)
+{
+	PackedDistanceMatrix matrix;
+	matrix.n = n;
+	matrix.backing = backing;
+	matrix.values = values;
+	return matrix;
+}
+
+/**
+ * Computes the distances of a row, from a vertex to every vertex after it.
+ * Rows can be filled by several threads at the same time.
+ * @param geo Trigonometry table of the vertexes.
+ * @param row Index of the vertex.
+ * @param buffer Scratch space, reused between calls.
+ * @note Complexity: O(n)
+*/
+void PackedDistanceMatrix::fillRow(const GeoTable &geo, int row, std::vector<double> &buffer)
+{
+	int count = n - row - 1;
+	if (count <= 0) return;
+	buffer.resize(count);
+	geo.distanceRow(row, row + 1, n, buffer.data());
+
+	float *out = owned.data() + rowStart(row);
+	for (int k = 0; k < count; k++)
+		out[k] = (float)buffer[k];
+}
+
+/**
+ * @return Amount of memory owned by the matrix, in bytes.
+ * Values viewed from elsewhere are not counted.
+*/
+size_t PackedDistanceMatrix::getMemoryUsage() const
+{
+	return owned.size() * sizeof(float);
+}
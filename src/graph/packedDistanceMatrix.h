@@ -0,0 +1,53 @@
+#ifndef PACKED_DISTANCE_MATRIX_H
+#define PACKED_DISTANCE_MATRIX_H
+
+#include "geo.h"
+#include <memory>
+
+/**
+ * Haversine distance between every pair of vertexes with coordinates,
+ * stored in single precision as the packed upper triangle of the matrix:
+ * the pairs (i, j), i < j, row after row. It takes n (n - 1) / 2 floats,
+ * about 200 MB for 10000 vertexes.
+ * The values are either owned or a view of memory kept alive by a shared handle,
+ * such as a memory-mapped file.
+*/
+class PackedDistanceMatrix {
+public:
+	PackedDistanceMatrix();
+	PackedDistanceMatrix(int n);
+	PackedDistanceMatrix(const PackedDistanceMatrix &) = delete;
+	PackedDistanceMatrix &operator=(const PackedDistanceMatrix &) = delete;
+	PackedDistanceMatrix(PackedDistanceMatrix &&) = default;
+	PackedDistanceMatrix &operator=(PackedDistanceMatrix &&) = default;
+
+	static PackedDistanceMatrix view(std::shared_ptr<const void> backing, int n, const float *values);
+	static size_t pairCount(int n) { return (size_t)n * (n - 1) / 2; }
+
+	int size() const { return n; }
+	bool empty() const { return n == 0; }
+	const float *data() const { return values; }
+
+	/**
+	 * @return Distance between two vertexes, 0 if they are the same.
+	*/
+	double get(int orig, int dest) const
+	{
+		if (orig == dest) return 0;
+		if (orig > dest) std::swap(orig, dest);
+		return values[rowStart(orig) + (dest - orig - 1)];
+	}
+
+	void fillRow(const GeoTable &geo, int row, std::vector<double> &buffer);
+	size_t getMemoryUsage() const;
+
+private:
+	int n = 0;
+	std::vector<float> owned;
+	std::shared_ptr<const void> backing;
+	const float *values = nullptr;
+
+	size_t rowStart(int row) const { return (size_t)row * n - (size_t)row * (row + 1) / 2; }
+};
+
+#endif
@@ -0,0 +1,109 @@
+#ifndef SPANNING_TREE_H
+#define SPANNING_TREE_H
+
+#include <vector>
+#include <algorithm>
+
+/**
+ * Spanning tree (or forest) of the vertex indexes 0 to n - 1, given by the parent of each vertex,
+ * as built by Prim's algorithm, and the children of each vertex once linkChildren is called.
+ * The searches walk the tree through these arrays, without building a graph of it.
+ * The neighbours of a vertex are walked in increasing order of index, whatever the root,
+ * which is the order of the adjacency of a CSR graph of the same tree.
+*/
+struct SpanningTree {
+	/** Parent of each vertex, -1 for the roots and the vertexes the tree does not reach. */
+	std::vector<int> parent;
+
+	/** Weight of the edge from each vertex to its parent. */
+	std::vector<double> weight;
+
+	/** Children of vertex v, by increasing index, at [childBegin[v], childBegin[v + 1]) of children. */
+	std::vector<int> childBegin;
+	std::vector<int> children;
+
+	SpanningTree() = default;
+
+	/**
+	 * Creates a tree of n vertexes without any edge.
+	 * @param rootWeight Weight given to every vertex, as it has no parent.
+	*/
+	SpanningTree(int n, double rootWeight) : parent(n, -1), weight(n, rootWeight) {}
+
+	/**
+	 * Fills the children of every vertex from the parents.
+	 * @note Complexity: O(n)
+	*/
+	void linkChildren()
+	{
+		int n = parent.size();
+		childBegin.assign(n + 1, 0);
+		for (int v = 0; v < n; v++)
+			if (parent[v] != -1) childBegin[parent[v] + 1]++;
+		for (int v = 0; v < n; v++)
+			childBegin[v + 1] += childBegin[v];
+		children.resize(childBegin[n]);
+		std::vector<int> next(childBegin.begin(), childBegin.end() - 1);
+		for (int v = 0; v < n; v++)
+			if (parent[v] != -1) children[next[parent[v]]++] = v;
+	}
+
+	/** @return Number of edges of the tree. */
+	size_t getNumEdges() const { return children.size(); }
+
+	/**
+	 * Calls visit(u, weight) for the parent and the children u of a vertex, by increasing index.
+	 * @note Complexity: O(degree of v)
+	*/
+	template <typename Visit>
+	void forEachNeighbour(int v, Visit visit) const
+	{
+		int up = parent[v];
+		for (int i = childBegin[v]; i < childBegin[v + 1]; i++)
+		{
+			if (up != -1 && up < children[i])
+			{
+				visit(up, weight[v]);
+				up = -1;
+			}
+			visit(children[i], weight[children[i]]);
+		}
+		if (up != -1) visit(up, weight[v]);
+	}
+
+	/**
+	 * Depth-first walk from a vertex, taking the neighbours by increasing index.
+	 * @param root Vertex the walk starts at, which need not be the root of the tree.
+	 * @return The vertexes of its tree, in the order they are first reached.
+	 * @note Complexity: O(n)
+	*/
+	std::vector<int> preorder(int root) const
+	{
+		std::vector<int> order, stack = {root};
+		std::vector<bool> visited(parent.size(), false);
+		visited[root] = true;
+		while (!stack.empty())
+		{
+			int v = stack.back();
+			stack.pop_back();
+			order.push_back(v);
+			size_t pushed = stack.size();
+			forEachNeighbour(v, [&](int u, double) {
+				if (visited[u]) return;
+				visited[u] = true;
+				stack.push_back(u);
+			});
+			std::reverse(stack.begin() + pushed, stack.end());
+		}
+		return order;
+	}
+
+	/** @return Bytes used by the arrays. */
+	size_t getMemoryUsage() const
+	{
+		return parent.capacity() * sizeof(int) + weight.capacity() * sizeof(double)
+			+ childBegin.capacity() * sizeof(int) + children.capacity() * sizeof(int);
+	}
+};
+
+#endif
@@ -0,0 +1,305 @@
+#ifndef TOUR_H
+#define TOUR_H
+
+#include <vector>
+#include <algorithm>
+#include <cmath>
+
+/**
+ * Tour through the vertex indexes 0 to n - 1 kept as an array of vertexes
+ * and the position of each vertex in it, for the local searches that flip paths of the tour.
+ * The tour may be read backwards from the array, so flipping a path reverses
+ * whichever of the path and the rest of the tour is shorter.
+*/
+class ArrayTour {
+public:
+	/**
+	 * Creates the tour visiting the vertexes in the given order.
+	 * @param order Every vertex index once.
+	 * @note Complexity: O(n)
+	*/
+	explicit ArrayTour(const std::vector<int> &order) : order(order), position(order.size())
+	{
+		for (size_t i = 0; i < order.size(); i++)
+			position[order[i]] = i;
+	}
+
+	int size() const { return (int)order.size(); }
+
+	int next(int v) const { return reversed ? before(position[v]) : after(position[v]); }
+	int prev(int v) const { return reversed ? after(position[v]) : before(position[v]); }
+
+	/**
+	 * @return True if b is reached no later than c, going forward from a.
+	*/
+	bool between(int a, int b, int c) const
+	{
+		return offset(a, b) <= offset(a, c);
+	}
+
+	/**
+	 * Reverses the path going forward from a to b, so that prev(a) is followed by b
+	 * and a by the old next(b).
+	 * @note Complexity: O(n), half the tour at most
+	*/
+	void flip(int a, int b)
+	{
+		int n = size();
+		int i = position[a], j = position[b];
+		if (reversed) std::swap(i, j);
+		int length = (j - i + n) % n + 1;
+		if (2 * length > n)
+		{
+			// Reversing the rest and reading the tour the other way gives the same tour
+			std::swap(i, j);
+			i = (i + 1) % n;
+			j = (j + n - 1) % n;
+			length = n - length;
+			reversed = !reversed;
+		}
+		for (int s = 0; s < length / 2; s++)
+		{
+			int x = i + s < n ? i + s : i + s - n, y = j - s >= 0 ? j - s : j - s + n;
+			std::swap(order[x], order[y]);
+			position[order[x]] = x;
+			position[order[y]] = y;
+		}
+	}
+
+	/**
+	 * @return The vertexes going forward from start.
+	 * @note Complexity: O(n)
+	*/
+	std::vector<int> vertexes(int start) const
+	{
+		std::vector<int> result;
+		result.reserve(order.size());
+		for (int v = start, i = 0; i < size(); v = next(v), i++)
+			result.push_back(v);
+		return result;
+	}
+
+private:
+	std::vector<int> order;
+	std::vector<int> position;
+	bool reversed = false;
+
+	int after(int i) const { return order[i + 1 == size() ? 0 : i + 1]; }
+	int before(int i) const { return order[i == 0 ? size() - 1 : i - 1]; }
+
+	int offset(int a, int b) const
+	{
+		int d = reversed ? position[a] - position[b] : position[b] - position[a];
+		return d < 0 ? d + size() : d;
+	}
+};
+
+/**
+ * Tour through the vertex indexes 0 to n - 1 kept as a two-level list: the tour is a
+ * sequence of segments of consecutive vertexes, each with a bit telling if it is read backwards.
+ * Flipping a path splits the segments at both of its ends, so the path is made of whole
+ * segments, then reverses their order in the sequence and flips their bits, without
+ * moving any vertex. Like ArrayTour, the whole tour may be read backwards, so the shorter of
+ * the path and the rest of the tour is the one reversed. The segments start with about
+ * sqrt(n) vertexes and are only split afterwards, and the tour is rebuilt into even segments
+ * once their number doubles, so next and prev are O(1) and flip is O(sqrt(n)) amortized.
+*/
+class TwoLevelTour {
+public:
+	/**
+	 * Creates the tour visiting the vertexes in the given order.
+	 * @param order Every vertex index once.
+	 * @note Complexity: O(n)
+	*/
+	explicit TwoLevelTour(const std::vector<int> &order) 
+		: vertexesOf(order), slot(order.size()), segmentOf(order.size())
+	{
+		rebuild();
+	}
+
+	int size() const { return (int)slot.size(); }
+
+	int next(int v) const { return reversed ? before(v) : after(v); }
+	int prev(int v) const { return reversed ? after(v) : before(v); }
+
+	/**
+	 * @return True if b is reached no later than c, going forward from a.
+	 * @note Complexity: O(1)
+	*/
+	bool between(int a, int b, int c) const
+	{
+		if (reversed) std::swap(a, c);
+		auto ka = key(a), kb = key(b), kc = key(c);
+		if (ka <= kc) return ka <= kb && kb <= kc;
+		return ka <= kb || kb <= kc;
+	}
+
+	/**
+	 * Reverses the path going forward from a to b, so that prev(a) is followed by b
+	 * and a by the old next(b).
+	 * @note Complexity: O(sqrt(n)) amortized
+	*/
+	void flip(int a, int b)
+	{
+		if (a == b) return;
+		if (reversed) std::swap(a, b);
+		splitBefore(a);
+		splitBefore(after(b));
+		int count = sequence.size();
+		int i = segments[segmentOf[a]].rank, j = segments[segmentOf[b]].rank;
+		int length = (j - i + count) % count + 1;
+		if (2 * length > count)
+		{
+			// Reversing the rest and reading the tour the other way gives the same tour
+			std::swap(i, j);
+			i = (i + 1) % count;
+			j = (j + count - 1) % count;
+			length = count - length;
+			reversed = !reversed;
+		}
+		for (int s = 0; s < length / 2; s++)
+			std::swap(sequence[(i + s) % count], sequence[(j - s + count) % count]);
+		for (int s = 0; s < length; s++)
+		{
+			Segment &segment = segments[sequence[(i + s) % count]];
+			segment.reversed = !segment.reversed;
+			segment.rank = (i + s) % count;
+		}
+		if (count > 2 * evenSegments) rebuild();
+	}
+
+	/**
+	 * @return The vertexes going forward from start.
+	 * @note Complexity: O(n)
+	*/
+	std::vector<int> vertexes(int start) const
+	{
+		std::vector<int> result;
+		result.reserve(size());
+		for (int v = start, i = 0; i < size(); v = next(v), i++)
+			result.push_back(v);
+		return result;
+	}
+
+private:
+	/** Vertexes [begin, end) of vertexesOf, and the position of the segment in the sequence. */
+	struct Segment {
+		int begin;
+		int end;
+		int rank;
+		bool reversed;
+	};
+
+	std::vector<int> vertexesOf;
+	std::vector<int> slot;
+	std::vector<int> segmentOf;
+	std::vector<Segment> segments;
+	std::vector<int> sequence;
+	int evenSegments = 0;
+	bool reversed = false;
+
+	int first(int s) const { return vertexesOf[segments[s].reversed ? segments[s].end - 1 : segments[s].begin]; }
+	int last(int s) const { return vertexesOf[segments[s].reversed ? segments[s].begin : segments[s].end - 1]; }
+
+	/** Next vertex, ignoring whether the whole tour is read backwards. */
+	int after(int v) const
+	{
+		const Segment &segment = segments[segmentOf[v]];
+		int i = slot[v];
+		if (!segment.reversed && i + 1 < segment.end) return vertexesOf[i + 1];
+		if (segment.reversed && i > segment.begin) return vertexesOf[i - 1];
+		return first(sequence[segment.rank + 1 == (int)sequence.size() ? 0 : segment.rank + 1]);
+	}
+
+	/** Previous vertex, ignoring whether the whole tour is read backwards. */
+	int before(int v) const
+	{
+		const Segment &segment = segments[segmentOf[v]];
+		int i = slot[v];
+		if (!segment.reversed && i > segment.begin) return vertexesOf[i - 1];
+		if (segment.reversed && i + 1 < segment.end) return vertexesOf[i + 1];
+		return last(sequence[segment.rank == 0 ? sequence.size() - 1 : segment.rank - 1]);
+	}
+
+	std::pair<int, int> key(int v) const
+	{
+		const Segment &segment = segments[segmentOf[v]];
+		return {segment.rank, segment.reversed ? segment.end - 1 - slot[v] : slot[v] - segment.begin};
+	}
+
+	/**
+	 * Lays the vertexes out in the order of the tour and splits them in segments
+	 * of about sqrt(n), none of them reversed.
+	 * @note Complexity: O(n)
+	*/
+	void rebuild()
+	{
+		int n = size();
+		if (!segments.empty())
+		{
+			std::vector<int> order;
+			order.reserve(n);
+			for (int s : sequence)
+			{
+				const Segment &segment = segments[s];
+				if (segment.reversed) order.insert(order.end(), 
+					vertexesOf.rbegin() + (n - segment.end), vertexesOf.rbegin() + (n - segment.begin));
+				else order.insert(order.end(), vertexesOf.begin() + segment.begin, vertexesOf.begin() + segment.end);
+			}
+			vertexesOf.swap(order);
+		}
+
+		int length = std::max(1, (int)std::sqrt((double)n));
+		segments.clear();
+		sequence.clear();
+		for (int begin = 0; begin < n; begin += length)
+		{
+			int end = std::min(n, begin + length);
+			for (int i = begin; i < end; i++)
+			{
+				slot[vertexesOf[i]] = i;
+				segmentOf[vertexesOf[i]] = segments.size();
+			}
+			sequence.push_back(segments.size());
+			segments.push_back({begin, end, (int)segments.size(), false});
+		}
+		evenSegments = segments.size();
+	}
+
+	/**
+	 * Splits the segment of a vertex so that the vertex starts a segment,
+	 * ignoring whether the whole tour is read backwards.
+	 * The smaller part becomes the new segment, so fewer vertexes change segment.
+	 * @note Complexity: O(sqrt(n))
+	*/
+	void splitBefore(int v)
+	{
+		int s = segmentOf[v];
+		if (first(s) == v) return;
+		Segment segment = segments[s];
+
+		// Vertexes [begin, middle) come before [middle, end) in the tour, or after it if reversed
+		int middle = segment.reversed ? slot[v] + 1 : slot[v];
+		bool upper = segment.end - middle <= middle - segment.begin;
+		int t = segments.size();
+		if (upper)
+		{
+			segments[s].end = middle;
+			segments.push_back({middle, segment.end, 0, segment.reversed});
+		}
+		else
+		{
+			segments[s].begin = middle;
+			segments.push_back({segment.begin, middle, 0, segment.reversed});
+		}
+		for (int i = segments[t].begin; i < segments[t].end; i++)
+			segmentOf[vertexesOf[i]] = t;
+
+		int rank = upper != segment.reversed ? segment.rank + 1 : segment.rank;
+		sequence.insert(sequence.begin() + rank, t);
+		for (int i = rank; i < (int)sequence.size(); i++)
+			segments[sequence[i]].rank = i;
+	}
+};
+
+#endif
@@ -2,6 +2,7 @@
 
 /**
  * Sets the console output mode to UTF8 if the platform is windows.
+ * Distances and times are shown with one decimal in every menu.
  * Calls the dataset selection menu.
 */
 int main(void)
@@ -9,6 +10,7 @@ int main(void)
 #ifdef _WIN32
 	SetConsoleOutputCP(CP_UTF8);
 #endif
+	std::cout << std::fixed << std::setprecision(1);
     UI().mainMenu();
     return 0;
 }
@@ -0,0 +1,257 @@
+#include "manager.h"
+#include "snapshot.h"
+#include "../graph/tour.h"
+#include <numeric>
+#include <random>
+
+/**
+ * Runs an operation several times and measures it.
+ * @param operation Operation to run.
+ * @param repeats Number of runs.
+ * @return Shortest time taken by a single run, in seconds.
+*/
+template <typename Operation>
+static double timeOperation(Operation operation, int repeats = 5)
+{
+	double best = INF;
+	for (int i = 0; i < repeats; i++)
+	{
+		auto start = std::chrono::high_resolution_clock::now();
+		operation();
+		auto end = std::chrono::high_resolution_clock::now();
+		best = std::min(best, std::chrono::duration<double>(end - start).count());
+	}
+	return best;
+}
+
+/**
+ * Keeps the compiler from discarding the result of a benchmarked operation.
+*/
+static volatile double benchmarkSink;
+
+/**
+ * Flips random paths of a tour of the vertexes 0 to n - 1, in order,
+ * reading the vertex after the start of each path.
+ * @param flips Starts and ends of the paths.
+*/
+template <typename Tour>
+static void flipTour(int n, const std::vector<std::pair<int, int>> &flips)
+{
+	std::vector<int> order(n);
+	std::iota(order.begin(), order.end(), 0);
+	Tour tour(order);
+	long sum = 0;
+	for (auto &flip : flips)
+	{
+		tour.flip(flip.first, flip.second);
+		sum += tour.next(flip.first);
+	}
+	benchmarkSink = sum;
+}
+
+/**
+ * Measures the operations used by the heuristics on the currently loaded dataset,
+ * comparing the pointer-based graph against the CSR representation
+ * and, for fully connected graphs, the distance matrix.
+ * Nearest-neighbor lists are compared against a full scan of each row,
+ * and on small graphs Held-Karp against backtracking.
+ * Borůvka's spanning tree is measured from one thread to one per hardware thread.
+ * The tours of the local searches are measured on their own, flipping random paths
+ * of tours of 1000 to 10000 vertexes.
+ * @note Complexity: O(V^2 log V)
+ * @return Timed operations. Baselines use the pointer-based graph.
+*/
+std::vector<BenchmarkEntry> Manager::runBenchmarks()
+{
+	std::vector<BenchmarkEntry> entries;
+	buildNetwork();
+	const std::vector<Vertex *> &vertexes = current.network.getVertexSet();
+	int n = current.csr.getNumVertex();
+
+	entries.push_back({"Build CSR from graph", -1,
+		timeOperation([&]() { CSRGraph tmp(current.network); benchmarkSink = tmp.getNumEdges(); })});
+
+	entries.push_back({"Adjacency sweep",
+		timeOperation([&]() {
+			double sum = 0;
+			for (auto vtx : vertexes)
+				for (auto edg : vtx->getAdj())
+					sum += edg->getWeight() + edg->getDest()->getId();
+			benchmarkSink = sum;
+		}),
+		timeOperation([&]() {
+			double sum = 0;
+			for (int v = 0; v < n; v++)
+				for (size_t e = current.csr.edgeBegin(v); e < current.csr.edgeEnd(v); e++)
+					sum += current.csr.getWeight(e) + current.csr.getDest(e);
+			benchmarkSink = sum;
+		})});
+
+	// Lookups in the pointer-based graph, also the baseline of the distance matrix lookups
+	double edgeLookup = timeOperation([&]() {
+		double sum = 0;
+		for (auto u : vertexes)
+			for (auto v : vertexes)
+			{
+				Edge *edg = u->getEdgeTo(v);
+				if (edg != nullptr) sum += edg->getWeight();
+			}
+		benchmarkSink = sum;
+	}, 1);
+	entries.push_back({"Edge lookup (all pairs)", edgeLookup,
+		timeOperation([&]() {
+			double sum = 0;
+			for (int u = 0; u < n; u++)
+				for (int v = 0; v < n; v++)
+				{
+					double w = current.csr.getWeight(u, v);
+					if (w != INF) sum += w;
+				}
+			benchmarkSink = sum;
+		}, 1)});
+
+	if (!current.matrix.empty())
+	{
+		entries.push_back({"Build distance matrix", -1,
+			timeOperation([&]() { DistanceMatrix tmp(current.csr); benchmarkSink = tmp.size(); })});
+
+		entries.push_back({"Distance lookup (all pairs)", edgeLookup,
+			timeOperation([&]() {
+				double sum = 0;
+				for (int u = 0; u < n; u++)
+				{
+					const double *row = current.matrix.row(u);
+					for (int v = 0; v < n; v++)
+						if (row[v] != INF) sum += row[v];
+				}
+				benchmarkSink = sum;
+			}, 1)});
+	}
+
+	if (!current.geo.empty())
+	{
+		std::vector<double> row(n);
+		entries.push_back({"Haversine (all pairs)",
+			timeOperation([&]() {
+				double sum = 0;
+				for (int u = 0; u < n; u++)
+					for (int v = 0; v < n; v++)
+						sum += haversineDistance(current.csr.getLat(u), current.csr.getLon(u), current.csr.getLat(v), current.csr.getLon(v));
+				benchmarkSink = sum;
+			}, 1),
+			timeOperation([&]() {
+				double sum = 0;
+				for (int u = 0; u < n; u++)
+				{
+					current.geo.distanceRow(u, 0, n, row.data());
+					sum += row[n / 2];
+				}
+				benchmarkSink = sum;
+			}, 1)});
+	}
+
+	if (!current.kdtree.empty() && n > 1)
+	{
+		const int k = std::min(10, n - 1);
+		std::vector<double> row(n);
+		std::vector<int> candidates(n);
+		entries.push_back({"Build k-d tree", -1,
+			timeOperation([&]() { KDTree tmp(current.csr); benchmarkSink = tmp.size(); })});
+
+		entries.push_back({"10-nearest lists (all vertexes)",
+			timeOperation([&]() {
+				double sum = 0;
+				for (int u = 0; u < n; u++)
+				{
+					current.geo.distanceRow(u, 0, n, row.data());
+					row[u] = INF;
+					std::iota(candidates.begin(), candidates.end(), 0);
+					std::partial_sort(candidates.begin(), candidates.begin() + k, candidates.end(),
+						[&](int a, int b) { return row[a] < row[b]; });
+					sum += candidates[k - 1];
+				}
+				benchmarkSink = sum;
+			}, 1),
+			timeOperation([&]() { benchmarkSink = candidateLists(k).size(); }, 1)});
+	}
+
+	if (!current.packed.empty())
+	{
+		entries.push_back({"Packed matrix (compute / map)",
+			timeOperation([&]() { benchmarkSink = computePackedMatrix().get(0, n - 1); }, 1),
+			timeOperation([&]() {
+				PackedDistanceMatrix tmp;
+				Snapshot::readMatrix(packedMatrixPath(), {current.coordinatesFile}, current.coordinatesRows, tmp);
+				benchmarkSink = tmp.size();
+			})});
+	}
+
+	if (n > 0)
+	{
+		entries.push_back({"Prim MST (heap / array)",
+			timeOperation([&]() { benchmarkSink = PrimParents(current.csr, 0, false).weight.back(); }),
+			timeOperation([&]() { benchmarkSink = PrimParents(current.csr, 0, true).weight.back(); })});
+
+		// Scaling of the parallel spanning tree from one thread to all of them, against Prim
+		double prim = timeOperation([&]() {
+			benchmarkSink = (current.implicitlyCompleted ? PrimMSTComplete(0) : PrimMST(current.csr, 0)).getNumEdges();
+		}, 1);
+		for (unsigned threads = 1; ; threads = std::min(threads * 2, getThreadCount()))
+		{
+			entries.push_back({"Boruvka MST, " + std::to_string(threads) + " thread(s) (Prim)", prim,
+				timeOperation([&]() { benchmarkSink = BoruvkaMST(threads).getNumEdges(); }, 1)});
+			if (threads >= getThreadCount()) break;
+		}
+	}
+
+	if (n > 1 && n <= 12 && current.csr.findIndex(0) != -1)
+	{
+		entries.push_back({"Exact tour (backtracking / Held-Karp)",
+			timeOperation([&]() { benchmarkSink = tspCaller(backtracking_2_1).totalDistance; }, 1),
+			timeOperation([&]() { benchmarkSink = tspCaller(held_karp).totalDistance; }, 1)});
+	}
+
+	std::mt19937 random(0);
+	for (int size : {1000, 3000, 10000})
+	{
+		std::vector<std::pair<int, int>> flips(20000);
+		std::uniform_int_distribution<int> vertex(0, size - 1);
+		for (auto &flip : flips)
+			flip = {vertex(random), vertex(random)};
+		entries.push_back({"Tour flips, n=" + std::to_string(size) + " (array/2-level)",
+			timeOperation([&]() { flipTour<ArrayTour>(size, flips); }),
+			timeOperation([&]() { flipTour<TwoLevelTour>(size, flips); })});
+	}
+
+	return entries;
+}
+
+/**
+ * Measures how long it takes to tear down and load the current dataset again,
+ * parsing its files and then from its snapshot.
+ * The dataset is reloaded, undoing any edge added to the graph.
+ * Implicit completion is restored afterwards.
+ * @note Complexity: O(V^2 + E log E)
+ * @return Timed operations.
+*/
+std::vector<BenchmarkEntry> Manager::runLoadBenchmarks()
+{
+	std::vector<BenchmarkEntry> entries;
+	DatasetType type = current.dType;
+	int opt = current.option;
+	bool implicit = current.implicitlyCompleted;
+
+	auto start = std::chrono::high_resolution_clock::now();
+	current.network.resetGraph();
+	auto end = std::chrono::high_resolution_clock::now();
+	entries.push_back({"Reset graph", -1, std::chrono::duration<double>(end - start).count()});
+
+	useSnapshots = false;
+	loadDataset(type, opt);
+	double parseTime = current.loadtime;
+	useSnapshots = true;
+	loadDataset(type, opt);
+	entries.push_back({"Load dataset (CSV / snapshot)", parseTime, current.loadtime});
+	if (implicit) implicitlyCompleteGraph();
+	return entries;
+}
@@ -0,0 +1,195 @@
+#include "csv.h"
+#include <charconv>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+
+#if defined(__unix__) || defined(__APPLE__)
+# include <sys/mman.h>
+# include <sys/stat.h>
+# include <fcntl.h>
+# include <unistd.h>
+# define CSV_MMAP
+#endif
+
+/**
+ * Opens a file and maps it into memory.
+ * Empty files are valid and have no contents.
+ * @param path Path to the file.
+*/
+MappedFile::MappedFile(const std::string &path)
+{
+#ifdef CSV_MMAP
+	int fd = ::open(path.c_str(), O_RDONLY);
+	if (fd == -1) return;
+
+	struct stat info;
+	if (fstat(fd, &info) == 0)
+	{
+		open = true;
+		length = info.st_size;
+		if (length > 0)
+		{
+			void *address = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+			if (address == MAP_FAILED) 
+			{
+				open = false;
+				length = 0;
+			}
+			else
+			{
+				madvise(address, length, MADV_SEQUENTIAL);
+				data = static_cast<const char *>(address);
+				mapped = true;
+			}
+		}
+	}
+	::close(fd);
+#else
+	std::ifstream file(path, std::ios::binary);
+	if (!file.is_open()) return;
+	buffer.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+	data = buffer.data();
+	length = buffer.size();
+	open = true;
+#endif
+}
+
+MappedFile::~MappedFile()
+{
+#ifdef CSV_MMAP
+	if (mapped) munmap(const_cast<char *>(data), length);
+#endif
+}
+
+/**
+ * @param begin First character of the buffer.
+ * @param end One past the last character of the buffer.
+ * @param firstLine Line number of the first line of the buffer.
+*/
+CsvReader::CsvReader(const char *begin, const char *end, size_t firstLine)
+	: cursor(begin), last(end), field(begin), rowEnd(begin), line(firstLine - 1) {}
+
+/**
+ * Moves to the next non-empty row.
+ * @return False if there are no rows left.
+ * @note Complexity: O(length of the row)
+*/
+bool CsvReader::nextRow()
+{
+	while (cursor < last)
+	{
+		const char *newline = static_cast<const char *>(memchr(cursor, '\n', last - cursor));
+		const char *stop = newline == nullptr ? last : newline;
+		line++;
+
+		field = cursor;
+		rowEnd = stop;
+		cursor = newline == nullptr ? last : newline + 1;
+		if (rowEnd > field && rowEnd[-1] == '\r') rowEnd--;
+		if (rowEnd == field) continue;
+
+		fieldsLeft = true;
+		return true;
+	}
+	fieldsLeft = false;
+	return false;
+}
+
+/**
+ * Finds the next field of the current row, trimmed.
+ * @return False if all fields were already read.
+*/
+bool CsvReader::nextField(const char *&first, const char *&stop)
+{
+	if (!fieldsLeft) return false;
+
+	const char *comma = static_cast<const char *>(memchr(field, ',', rowEnd - field));
+	first = field;
+	stop = comma == nullptr ? rowEnd : comma;
+	fieldsLeft = comma != nullptr;
+	field = comma == nullptr ? rowEnd : comma + 1;
+
+	while (first < stop && (*first == ' ' || *first == '\t')) first++;
+	while (stop > first && (stop[-1] == ' ' || stop[-1] == '\t')) stop--;
+	return true;
+}
+
+/**
+ * Reads the next field as an integer.
+ * Integral values written with a decimal part ("12.0") are also accepted.
+*/
+bool CsvReader::readInt(int &value)
+{
+	const char *first, *stop;
+	if (!nextField(first, stop) || first == stop) return false;
+
+	auto result = std::from_chars(first, stop, value);
+	if (result.ec == std::errc() && result.ptr == stop) return true;
+
+	double real;
+	auto fallback = std::from_chars(first, stop, real);
+	if (fallback.ec != std::errc() || fallback.ptr != stop) return false;
+	if (real != std::floor(real) || std::fabs(real) > 2147483647.0) return false;
+	value = (int)real;
+	return true;
+}
+
+/**
+ * Reads the next field as a real number.
+*/
+bool CsvReader::readDouble(double &value)
+{
+	const char *first, *stop;
+	if (!nextField(first, stop) || first == stop) return false;
+
+	auto result = std::from_chars(first, stop, value);
+	return result.ec == std::errc() && result.ptr == stop;
+}
+
+/**
+ * Reads the next field as text. The view points into the buffer.
+*/
+bool CsvReader::readText(std::string_view &value)
+{
+	const char *first, *stop;
+	if (!nextField(first, stop)) return false;
+	value = std::string_view(first, stop - first);
+	return true;
+}
+
+/**
+ * @return True if every field of the current row was read.
+*/
+bool CsvReader::rowEnded() const
+{
+	return !fieldsLeft;
+}
+
+/**
+ * Splits a buffer into chunks of about the same size that start at the beginning of a line,
+ * so that each of them can be parsed on its own.
+ * @param begin First character of the buffer.
+ * @param end One past the last character of the buffer.
+ * @param chunks Wanted number of chunks. Fewer are made if lines are too long.
+ * @return Chunk boundaries: chunk i is [bounds[i], bounds[i + 1]).
+ * @note Complexity: O(chunks + length of the longest line)
+*/
+std::vector<const char *> CsvReader::splitChunks(const char *begin, const char *end, 
+	size_t chunks)
+{
+	std::vector<const char *> bounds = {begin};
+	size_t length = end - begin;
+	if (chunks == 0) chunks = 1;
+
+	for (size_t i = 1; i < chunks; i++)
+	{
+		const char *target = begin + length / chunks * i;
+		if (target <= bounds.back()) continue;
+		const char *newline = static_cast<const char *>(memchr(target - 1, '\n', end - target + 1));
+		if (newline == nullptr) break;
+		if (newline + 1 > bounds.back() && newline + 1 < end) bounds.push_back(newline + 1);
+	}
+	bounds.push_back(end);
+	return bounds;
+}
@@ -0,0 +1,68 @@
+#ifndef CSV_H
+#define CSV_H
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <cstddef>
+
+/**
+ * Read-only view of the whole contents of a file.
+ * The file is memory-mapped where the platform allows it,
+ * otherwise it is read into a buffer.
+*/
+class MappedFile {
+public:
+	MappedFile(const std::string &path);
+	~MappedFile();
+	MappedFile(const MappedFile &) = delete;
+	MappedFile &operator=(const MappedFile &) = delete;
+
+	bool isOpen() const { return open; }
+	const char *begin() const { return data; }
+	const char *end() const { return data + length; }
+	size_t size() const { return length; }
+
+private:
+	const char *data = nullptr;
+	size_t length = 0;
+	bool open = false;
+	bool mapped = false;
+	std::vector<char> buffer;
+};
+
+/**
+ * Parses comma separated rows directly over a character buffer, without allocating.
+ * Rows end with '\n', and a '\r' right before it is ignored. Empty lines are skipped.
+ * Spaces and tabs around a field are ignored.
+ * Each read function consumes the next field of the current row
+ * and returns false if there is no such field or it is not valid.
+*/
+class CsvReader {
+public:
+	CsvReader(const char *begin, const char *end, size_t firstLine = 1);
+
+	bool nextRow();
+	bool readInt(int &value);
+	bool readDouble(double &value);
+	bool readText(std::string_view &value);
+	bool rowEnded() const;
+
+	size_t getLine() const { return line; }
+	const char *getPosition() const { return cursor; }
+
+	static std::vector<const char *> splitChunks(const char *begin, const char *end, 
+		size_t chunks);
+
+private:
+	const char *cursor;
+	const char *last;
+	const char *field;
+	const char *rowEnd;
+	bool fieldsLeft = false;
+	size_t line;
+
+	bool nextField(const char *&first, const char *&stop);
+};
+
+#endif
@@ -0,0 +1,194 @@
+#include "dataset.h"
+#include <sstream>
+
+/**
+ * @return True if the file still has the size and modification time it had when recorded.
+*/
+bool SourceFile::unchanged() const
+{
+	std::error_code error;
+	uintmax_t currentSize = std::filesystem::file_size(path, error);
+	if (error) return false;
+	std::filesystem::file_time_type currentTime = std::filesystem::last_write_time(path, error);
+	return !error && currentSize == size && currentTime == modified;
+}
+
+/**
+ * Records the size and modification time of a file the dataset is loaded from.
+ * Should be called before reading the file.
+ * @param path Path to the file.
+*/
+void Dataset::addSource(const std::string &path)
+{
+	SourceFile source;
+	source.path = path;
+	std::error_code error;
+	source.size = std::filesystem::file_size(path, error);
+	source.modified = std::filesystem::last_write_time(path, error);
+	sources.push_back(source);
+}
+
+/**
+ * @return True if any file the dataset was loaded from changed since.
+ * @note Complexity: O(1)
+*/
+bool Dataset::isStale() const
+{
+	for (const SourceFile &source : sources)
+		if (!source.unchanged()) return true;
+	return false;
+}
+
+/**
+ * @return Approximate amount of memory used by the dataset, in bytes.
+ * Memory-mapped snapshots and matrixes are not counted,
+ * their pages belong to the page cache.
+ * @note Complexity: O(V)
+*/
+size_t Dataset::getMemoryUsage() const
+{
+	size_t bytes = network.getMemoryUsage() + csr.getMemoryUsage() + matrix.getMemoryUsage()
+		+ geo.getMemoryUsage() + kdtree.getMemoryUsage() + packed.getMemoryUsage();
+	for (const std::string &label : labels)
+		bytes += sizeof(std::string) + label.size();
+	for (auto &mst : msts)
+		bytes += mst.second->getMemoryUsage();
+	return bytes;
+}
+
+/**
+ * @return True if the dataset is resident, whether or not its files changed.
+ * @note Complexity: O(D), D being the number of cached datasets
+*/
+bool DatasetCache::contains(DatasetType type, int option) const
+{
+	for (const Entry &entry : entries)
+		if (entry.dataset.dType == type && entry.dataset.option == option) return true;
+	return false;
+}
+
+/**
+ * Removes a dataset from the cache, if it is resident and its files did not change.
+ * @param type Type of the dataset.
+ * @param option Option of the dataset.
+ * @param out Dataset to move the cached one into.
+ * @return True if the dataset was found.
+ * @note Complexity: O(D), D being the number of cached datasets
+*/
+bool DatasetCache::take(DatasetType type, int option, Dataset &out)
+{
+	for (auto it = entries.begin(); it != entries.end(); it++)
+	{
+		if (it->dataset.dType != type || it->dataset.option != option) continue;
+		used -= it->bytes;
+		bool stale = it->dataset.isStale();
+		if (!stale) out = std::move(it->dataset);
+		entries.erase(it);
+		return !stale;
+	}
+	return false;
+}
+
+/**
+ * Adds a dataset to the cache as the most recently used one,
+ * evicting the least recently used ones that no longer fit in the budget.
+ * A dataset larger than the whole budget is not kept.
+ * @param dataset Dataset to cache.
+ * @note Complexity: O(V + D)
+*/
+void DatasetCache::put(Dataset &&dataset)
+{
+	if (dataset.dType == none) return;
+	size_t bytes = dataset.getMemoryUsage();
+	if (bytes > budget) return;
+	entries.push_front({std::move(dataset), bytes});
+	used += bytes;
+	evict();
+}
+
+/**
+ * Releases every cached dataset.
+*/
+void DatasetCache::clear()
+{
+	entries.clear();
+	used = 0;
+}
+
+/**
+ * Evicts the least recently used datasets until the cache fits in its budget.
+*/
+void DatasetCache::evict()
+{
+	while (used > budget)
+	{
+		used -= entries.back().bytes;
+		entries.pop_back();
+	}
+}
+
+/**
+ * Changes the memory budget, evicting datasets if they no longer fit.
+ * @param bytes New budget, in bytes. Zero disables the cache.
+*/
+void DatasetCache::setBudget(size_t bytes)
+{
+	budget = bytes;
+	evict();
+}
+
+/**
+ * @return Memory budget, in bytes.
+*/
+size_t DatasetCache::getBudget() const
+{
+	return budget;
+}
+
+/**
+ * @return Approximate amount of memory used by the cached datasets, in bytes.
+*/
+size_t DatasetCache::getMemoryUsage() const
+{
+	return used;
+}
+
+/**
+ * @return Names of the cached datasets, most recently used first.
+*/
+std::vector<std::string> DatasetCache::getResident() const
+{
+	std::vector<std::string> names;
+	for (const Entry &entry : entries)
+		names.push_back(datasetName(entry.dataset.dType, entry.dataset.option));
+	return names;
+}
+
+/**
+ * Converts a dataset type and option to a string with its name.
+ * @param type Dataset type
+ * @param option Dataset option, for the types that need one
+ * @return Dataset name as a formatted string
+*/
+std::string datasetName(DatasetType type, int option)
+{
+	std::ostringstream out;
+	switch (type) {
+		case none:
+			return "None";
+		case toy_shipping:
+			return "Toy - Shipping";
+		case toy_stadiums:
+			return "Toy - Stadiums";
+		case toy_tourism:
+			return "Toy - Tourism";
+		case real_world:
+			out << "Real World - Graph " << option;
+			return out.str();
+		case extra:
+			out << "Extra - " << option << " Nodes";
+			return out.str();
+		default:
+			return "None";
+	};
+}
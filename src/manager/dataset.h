@@ -0,0 +1,118 @@
+#ifndef DATASET_H
+#define DATASET_H
+
+#include "../graph/graph.h"
+#include "../graph/csr.h"
+#include "../graph/distanceMatrix.h"
+#include "../graph/geo.h"
+#include "../graph/kdtree.h"
+#include "../graph/packedDistanceMatrix.h"
+#include "../graph/spanningTree.h"
+#include <string>
+#include <vector>
+#include <list>
+#include <map>
+#include <memory>
+#include <filesystem>
+#include <cstdint>
+
+/**
+ * Dataset types
+*/
+enum DatasetType {
+	none,
+	toy_shipping,
+	toy_stadiums,
+	toy_tourism,
+	real_world,
+	extra
+};
+
+/**
+ * Size and modification time of a file a dataset was loaded from.
+*/
+struct SourceFile {
+	std::string path;
+	uintmax_t size = 0;
+	std::filesystem::file_time_type modified;
+
+	bool unchanged() const;
+};
+
+/**
+ * A loaded dataset: its graph and every structure derived from it.
+ * Datasets are moved as a whole between the manager and the dataset cache.
+*/
+struct Dataset {
+	DatasetType dType = none;
+	int option = -1;
+	double loadtime = -1;
+
+	Graph network;
+	CSRGraph csr;
+	DistanceMatrix matrix;
+	GeoTable geo;
+	KDTree kdtree;
+	bool fullyConnected = true;
+	bool implicitlyCompleted = false;
+	uint64_t completionGeneration = 0;
+
+	PackedDistanceMatrix packed;
+	std::string coordinatesFile;
+	long coordinatesRows = -1;
+
+	std::vector<std::string> loadWarnings;
+	size_t skippedRows = 0;
+
+	/** False while a dataset loaded from a snapshot has no pointer-based graph yet. */
+	bool networkBuilt = true;
+	std::vector<std::string> labels;
+
+	/** Minimum spanning trees already built, by base vertex index (the smallest int for the Borůvka tree, which has no base). */
+	mutable std::map<int, std::shared_ptr<const SpanningTree>> msts;
+
+	/** Files the dataset was loaded from. */
+	std::vector<SourceFile> sources;
+
+	void addSource(const std::string &path);
+	bool isStale() const;
+	size_t getMemoryUsage() const;
+};
+
+/**
+ * Keeps datasets that are not selected resident in memory, so selecting them
+ * again needs no I/O. The least recently used datasets are evicted
+ * once their total size exceeds the memory budget.
+*/
+class DatasetCache {
+public:
+	/** Default memory budget, in bytes. */
+	static const size_t DEFAULT_BUDGET = (size_t)1 << 30;
+
+	bool contains(DatasetType type, int option) const;
+	bool take(DatasetType type, int option, Dataset &out);
+	void put(Dataset &&dataset);
+	void clear();
+
+	void setBudget(size_t bytes);
+	size_t getBudget() const;
+	size_t getMemoryUsage() const;
+	std::vector<std::string> getResident() const;
+
+private:
+	struct Entry {
+		Dataset dataset;
+		size_t bytes;
+	};
+
+	/** Cached datasets, most recently used first. */
+	std::list<Entry> entries;
+	size_t budget = DEFAULT_BUDGET;
+	size_t used = 0;
+
+	void evict();
+};
+
+std::string datasetName(DatasetType type, int option);
+
+#endif
@@ -1,42 +1,213 @@
 #include "../manager.h"
+#include <array>
+#include <type_traits>
+
+/** Search steps between two readings of the clock, to stop at the deadline. */
+#define BACKTRACK_CHECK_STEPS 4096
+
+/**
+ * Smallest integer type with at least N bits, used as the set of visited vertexes.
+*/
+template <int N>
+using VisitedMask = typename std::conditional<N <= 16, uint16_t,
+	typename std::conditional<N <= 32, uint32_t, uint64_t>::type>::type;
+
+/**
+ * Backtracking state for graphs of at most N vertexes, kept in fixed-size arrays
+ * so that the search allocates nothing and the bounds of its loops are known at compile time.
+*/
+template <int N>
+struct SmallBacktrack {
+	/** distances[v * N + u] = weight of the edge from v to u. */
+	std::array<double, N * N> distances;
+
+	/** neighbours[v * N + k] = destination of the k-th edge of v, in the order of the graph. */
+	std::array<uint8_t, N * N> neighbours;
+	std::array<uint8_t, N> degree;
+
+	/** Weight of the shortest edge leaving each vertex. */
+	std::array<double, N> cheapest;
+
+	/** Explicit stack: the vertex, the next edge to try and the cheapest edges
+	 * leaving the vertexes not yet in the path at each depth. */
+	std::array<uint8_t, N> path;
+	std::array<uint8_t, N> cursor;
+	std::array<double, N> rest;
+
+	std::array<uint8_t, N> bestPath;
+
+	double solve(const CSRGraph &g, int start, SolveControl &control,
+		const std::function<void(double)> &improved);
+};
+
+/**
+ * Iterative backtracking with an explicit stack and a bitmask of visited vertexes.
+ * Edges are tried in the same order as the recursive version, and only a strictly
+ * shorter tour replaces the best one, so both find the same tour.
+ * Besides paths already longer than the best tour, it prunes those that cannot be
+ * completed in time, as every vertex left must still be left through its shortest edge at best.
+ * @param g Base graph, with at most N vertexes.
+ * @param start Index of the vertex where the tour starts and ends.
+ * @param control Stops the search, which then keeps the best tour found so far.
+ * @param improved Called with the length of each shorter tour, once it is in bestPath.
+ * @return Length of the shortest tour, the largest double if there is none.
+ * The tour is in bestPath, without the return to the start.
+ * @note Complexity: O(V!)
+*/
+template <int N>
+double SmallBacktrack<N>::solve(const CSRGraph &g, int start, SolveControl &control,
+	const std::function<void(double)> &improved)
+{
+	// Parallel edges keep the position of the first one and the weight of the shortest one
+	int n = g.getNumVertex();
+	distances.fill(INF);
+	for (int v = 0; v < n; v++)
+	{
+		degree[v] = 0;
+		for (size_t e = g.edgeBegin(v); e < g.edgeEnd(v); e++)
+		{
+			int u = g.getDest(e);
+			if (distances[v * N + u] == INF) neighbours[v * N + degree[v]++] = u;
+			distances[v * N + u] = std::min(distances[v * N + u], g.getWeight(e));
+		}
+		cheapest[v] = INF;
+		for (int k = 0; k < degree[v]; k++)
+			cheapest[v] = std::min(cheapest[v], distances[v * N + neighbours[v * N + k]]);
+	}
+
+	// The length is added to and subtracted from like in the recursive version,
+	// so tours of the same length up to rounding are told apart the same way
+	double best = std::numeric_limits<double>::max();
+	double current = 0;
+	VisitedMask<N> visited = (VisitedMask<N>)1 << start;
+	int depth = 0;
+	path[0] = start;
+	cursor[0] = 0;
+	rest[0] = 0;
+	for (int v = 0; v < n; v++)
+		if (v != start) rest[0] += cheapest[v];
+	for (size_t steps = 1; depth >= 0; steps++)
+	{
+		if (steps % BACKTRACK_CHECK_STEPS == 0 && control.check()) break;
+		int v = path[depth];
+		if (cursor[depth] == degree[v])
+		{
+			visited &= ~((VisitedMask<N>)1 << v);
+			if (depth > 0) current -= distances[path[depth - 1] * N + v];
+			depth--;
+			continue;
+		}
+		int u = neighbours[v * N + cursor[depth]++];
+		if (u == start)
+		{
+			current += distances[v * N + u];
+			if (depth == n - 1 && current < best)
+			{
+				best = current;
+				bestPath = path;
+				improved(best);
+			}
+			current -= distances[v * N + u];
+			continue;
+		}
+		if (visited >> u & 1) continue;
+		current += distances[v * N + u];
+
+		// Every vertex left, u included, is yet to be left once. With some slack for rounding,
+		// this only prunes paths that cannot tie with the best tour, so the same tour is found
+		double left = rest[depth] - cheapest[u];
+		if (current > best || (current + cheapest[u] + left) * (1 - 1e-9) > best)
+		{
+			current -= distances[v * N + u];
+			continue;
+		}
+
+		depth++;
+		path[depth] = u;
+		cursor[depth] = 0;
+		rest[depth] = left;
+		visited |= (VisitedMask<N>)1 << u;
+	}
+	return best;
+}
+
+/**
+ * Runs the iterative backtracking for graphs of at most N vertexes, with its state on the stack.
+ * @param stops Filled with the ids of the shortest tour, starting and ending at start.
+ * @param control Stops the search, and gets each shorter tour.
+ * @param build Makes the result of a tour given by vertex indexes, only called for tours
+ * the control accepts.
+ * @return Length of the shortest tour, the largest double if there is none.
+*/
+template <int N>
+static double smallBacktracking(const CSRGraph &g, int start, std::vector<int> &stops, SolveControl &control,
+	const std::function<ReturnDataTSP(const std::vector<int>&)> &build)
+{
+	SmallBacktrack<N> search;
+	int n = g.getNumVertex();
+	double best = search.solve(g, start, control, [&](double length) {
+		control.report(length, [&]() {
+			std::vector<int> order(search.bestPath.begin(), search.bestPath.begin() + n);
+			order.push_back(start);
+			return build(order);
+		});
+	});
+	if (best == std::numeric_limits<double>::max()) return best;
+	for (int i = 0; i < n; i++)
+		stops.push_back(g.getId(search.bestPath[i]));
+	stops.push_back(g.getId(start));
+	return best;
+}
 
 /**
  * Main section of the backtracking algorithm. 
  * It uses recursion to transverse the graph (depth-first search).
  * While doing so, it keeps a track of the path with the smallest distance.
  * @param g Base graph.
- * @param v Base vertex.
+ * @param v Index of the current vertex.
+ * @param start Index of the vertex where the tour starts and ends.
+ * @param visited Marks the vertexes already in the current path, by index.
  * @param currentPath Vector with the path currently being evaluated.
  * @param currentDistance Value of the distance travelled with the path in currentPath.
  * @param bestDistance Saves the value of the path with best distance.
  * @param bestPath Saves the shortest path found yet.
+ * @param control Stops the search, and gets each shorter tour.
+ * @param steps Number of calls so far, to read the clock only every so often.
  * @note Complexity: O(V!)
 */
-void Manager::backtrack(Graph* g, Vertex* v, std::vector<int>& currentPath, double& currentDistance, 
-	double* bestDistance, std::vector<int>* bestPath)
+void Manager::backtrack(const CSRGraph &g, int v, int start, std::vector<bool> &visited,
+	std::vector<int>& currentPath, double& currentDistance, double* bestDistance, std::vector<int>* bestPath,
+	SolveControl &control, size_t &steps) const
 {
     if (currentDistance > *bestDistance 
-		|| (g->findVertex(0) == v && currentDistance != 0 && (int) currentPath.size() != g->getNumVertex())) return;
+		|| (v == start && currentDistance != 0 && (int) currentPath.size() != g.getNumVertex())) return;
+    if (++steps % BACKTRACK_CHECK_STEPS == 0 ? control.check() : control.isStopped()) return;
 
-    currentPath.push_back(v->getId());
+    currentPath.push_back(g.getId(v));
 
-    for (auto edge : v->getAdj())
+    for (size_t e = g.edgeBegin(v); e < g.edgeEnd(v); e++)
 	{
-        Vertex* child = edge->getDest();
-        if (!child->isVisited())
+        int child = g.getDest(e);
+        if (!visited[child])
 		{
-            child->setVisited(true);
-            currentDistance += edge->getWeight();
-            backtrack(g, child, currentPath, currentDistance, bestDistance, bestPath);
-            currentDistance -= edge->getWeight();
-            child->setVisited(false);
+            visited[child] = true;
+            currentDistance += g.getWeight(e);
+            backtrack(g, child, start, visited, currentPath, currentDistance, bestDistance, bestPath, control, steps);
+            currentDistance -= g.getWeight(e);
+            visited[child] = false;
         }
     }
 
-    if ((int)currentPath.size() == g->getNumVertex() + 1 && *bestDistance > currentDistance)
+    if ((int)currentPath.size() == g.getNumVertex() + 1 && *bestDistance > currentDistance)
 	{
         *bestDistance = currentDistance;
         *bestPath = currentPath;
+        control.report(currentDistance, [&]() {
+            std::vector<int> order;
+            for (int id : currentPath)
+                order.push_back(g.findIndex(id));
+            return tourOf(order, control.elapsed());
+        });
     }
 
     currentPath.pop_back();
@@ -46,33 +217,43 @@ void Manager::backtrack(Graph* g, Vertex* v, std::vector<int>& currentPath, doub
  * Backtracking transverses the graph using depth first search, 
  * while keeping track of every transversal and its current cost.
  * At the end, the minimum cost transversal is returned. 
+ * Graphs of up to 64 vertexes use an iterative version sized for them at compile time.
+ * If the control stops the search, the shortest tour found so far is returned instead.
+ * @param control Deadline, cancellation and callback of the run.
  * @note Complexity: O(V!)
  * @return Structure with the time taken, stops, distances between stops and max distance travelled.
 */
-ReturnDataTSP Manager::backtrackingHeuristic()
+ReturnDataTSP Manager::backtrackingHeuristic(SolveControl &control) const
 {
     auto start = std::chrono::high_resolution_clock::now();
     double totalDistance = std::numeric_limits<double>::max();
     std::vector<int> stops;
     std::vector<double> distances;
     std::vector<int> path;
-    double current = 0;
+    double length = 0;
     
-    Vertex* initial = network.findVertex(0);
+    int initial = current.csr.findIndex(0);
+	if (initial == -1) return {-1, {}, {}, -1};
 
-    for (auto v : network.getVertexSet()) v->setVisited(false);
+    auto build = [&](const std::vector<int> &order) { return tourOf(order, control.elapsed()); };
 
-    backtrack(&network, initial, path, current, &totalDistance, &stops);
+    // Small graphs use the iterative kernel sized for them, larger ones the recursive search
+    int n = current.csr.getNumVertex();
+    if (n <= 16) totalDistance = smallBacktracking<16>(current.csr, initial, stops, control, build);
+    else if (n <= 32) totalDistance = smallBacktracking<32>(current.csr, initial, stops, control, build);
+    else if (n <= 64) totalDistance = smallBacktracking<64>(current.csr, initial, stops, control, build);
+    else
+    {
+        std::vector<bool> visited(n, false);
+        size_t steps = 0;
+        backtrack(current.csr, initial, initial, visited, path, length, &totalDistance, &stops, control, steps);
+    }
 
 	for (int i = 0; i < (int)(stops.size()) - 1; i++)
-	{
-		for (auto edge : network.findVertex(stops[i])->getAdj())
-		{
-			if (edge->getDest() == network.findVertex(stops[i + 1]))
-				distances.push_back(edge->getWeight());
-		}
-	}
+		distances.push_back(distance(current.csr.findIndex(stops[i]), current.csr.findIndex(stops[i + 1])));
 
 	auto end = std::chrono::high_resolution_clock::now();
-    return {std::chrono::duration<double>(end - start).count(), stops, distances, totalDistance};
+    ReturnDataTSP result = {std::chrono::duration<double>(end - start).count(), stops, distances, totalDistance};
+    result.interrupted = control.isStopped();
+    return result;
 }
@@ -0,0 +1,173 @@
+#include "../manager.h"
+
+/**
+ * Union-find over vertex indexes where finds and unions run concurrently without locks.
+ * Roots are only linked below smaller indexes, by compare-and-swap,
+ * so links always go down in index and can never form a cycle.
+ * Finds halve the paths they go through, which only ever replaces
+ * a parent with one of its ancestors, so concurrent finds stay correct.
+*/
+class ConcurrentUnionFind {
+public:
+	explicit ConcurrentUnionFind(int n) : parent(n)
+	{
+		for (int v = 0; v < n; v++)
+			parent[v].store(v, std::memory_order_relaxed);
+	}
+
+	int find(int v)
+	{
+		while (true)
+		{
+			int p = parent[v].load();
+			int grandparent = parent[p].load();
+			if (p == grandparent) return p;
+			parent[v].compare_exchange_weak(p, grandparent);
+			v = grandparent;
+		}
+	}
+
+	/**
+	 * @return False if both vertexes were already in the same component.
+	*/
+	bool unite(int a, int b)
+	{
+		while (true)
+		{
+			a = find(a);
+			b = find(b);
+			if (a == b) return false;
+			if (a < b) std::swap(a, b);
+			int root = a;
+			if (parent[a].compare_exchange_strong(root, b)) return true;
+		}
+	}
+
+private:
+	std::vector<std::atomic<int>> parent;
+};
+
+/**
+ * Strict total order of the edges: by weight, then by their ends.
+ * Every component picking its cheapest edge by this order never closes a cycle.
+*/
+static bool lighter(double w1, int a1, int b1, double w2, int a2, int b2)
+{
+	if (w1 != w2) return w1 < w2;
+	if (std::min(a1, b1) != std::min(a2, b2)) return std::min(a1, b1) < std::min(a2, b2);
+	return std::max(a1, b1) < std::max(a2, b2);
+}
+
+/**
+ * Creates a minimum spanning forest of the network with Borůvka's algorithm, in parallel.
+ * Each round, every vertex finds the cheapest edge leaving its component in parallel,
+ * each component keeps the cheapest of those of its vertexes through a compare-and-swap,
+ * and the components are merged along them in parallel with a lock-free union-find.
+ * The components at least halve every round, so there are at most log V rounds.
+ * The cheapest edges are taken from the edges of the network, or from rows of distances
+ * if it is implicitly completed.
+ * @param threads Number of threads, 0 meaning getThreadCount().
+ * @return Forest over the vertex indexes of the network, each tree rooted at its lowest index,
+ * with its children linked.
+ * @note Complexity: O((E + V) log V) work, or O(V^2 log V) if implicitly completed,
+ * split between the threads.
+*/
+SpanningTree Manager::BoruvkaMST(unsigned threads) const
+{
+	int n = current.csr.getNumVertex();
+	if (threads == 0) threads = getThreadCount();
+
+	ConcurrentUnionFind components(n);
+	std::vector<int> component(n), target(n, -1);
+	std::vector<double> cost(n, INF);
+	std::vector<std::atomic<int>> cheapest(n);
+	std::vector<std::vector<double>> rows(threads);
+	std::vector<std::vector<CSREdge>> found(threads);
+
+	while (true)
+	{
+		parallelFor(0, n, [&](size_t v, unsigned) {
+			component[v] = components.find(v);
+			cheapest[v].store(-1, std::memory_order_relaxed);
+		}, threads, 1024);
+
+		// Cheapest edge leaving the component of each vertex. Components only grow,
+		// so the one of the last round is still the cheapest if it still leaves the component
+		parallelFor(0, n, [&](size_t i, unsigned thread) {
+			int v = i;
+			int to = target[v];
+			double weight = cost[v];
+			if (to == -1 || component[to] == component[v])
+			{
+				to = -1;
+				weight = INF;
+				auto consider = [&](int u, double w) {
+					if (w == INF || component[u] == component[v]) return;
+					if (to == -1 || lighter(w, v, u, weight, v, to)) to = u, weight = w;
+				};
+				if (current.implicitlyCompleted)
+				{
+					std::vector<double> &row = rows[thread];
+					distanceRow(v, row);
+					for (int u = 0; u < n; u++)
+						consider(u, row[u]);
+				}
+				else
+				{
+					for (size_t e = current.csr.edgeBegin(v); e < current.csr.edgeEnd(v); e++)
+						consider(current.csr.getDest(e), current.csr.getWeight(e));
+				}
+				target[v] = to;
+				cost[v] = weight;
+			}
+			if (to == -1) return;
+
+			std::atomic<int> &best = cheapest[component[v]];
+			int held = best.load();
+			while ((held == -1 || lighter(weight, v, to, cost[held], held, target[held]))
+				&& !best.compare_exchange_weak(held, v)) {}
+		}, threads, 16);
+
+		// Merge the components along their cheapest edges,
+		// an edge picked by both of its components is only added once
+		std::atomic<size_t> merged(0);
+		parallelFor(0, n, [&](size_t c, unsigned thread) {
+			int v = cheapest[c].load(std::memory_order_relaxed);
+			if (v == -1 || !components.unite(v, target[v])) return;
+			found[thread].push_back({v, target[v], cost[v]});
+			merged++;
+		}, threads, 1024);
+		if (merged == 0) break;
+	}
+
+	std::vector<CSREdge> edges;
+	for (auto &part : found)
+		edges.insert(edges.end(), part.begin(), part.end());
+	CSRGraph forest(current.csr.getIds(), edges, true);
+
+	// Parents found by a breadth-first search from the lowest index of each tree
+	SpanningTree tree(n, 0);
+	std::vector<bool> reached(n, false);
+	std::vector<int> queue;
+	for (int root = 0; root < n; root++)
+	{
+		if (reached[root]) continue;
+		reached[root] = true;
+		queue.assign(1, root);
+		for (size_t i = 0; i < queue.size(); i++)
+		{
+			int v = queue[i];
+			for (size_t e = forest.edgeBegin(v); e < forest.edgeEnd(v); e++)
+			{
+				int u = forest.getDest(e);
+				if (reached[u]) continue;
+				reached[u] = true;
+				tree.parent[u] = v;
+				tree.weight[u] = forest.getWeight(e);
+				queue.push_back(u);
+			}
+		}
+	}
+	tree.linkChildren();
+	return tree;
+}
@@ -0,0 +1,494 @@
+#include "../manager.h"
+#include <cmath>
+#include <deque>
+#include <mutex>
+
+/** Largest number of vertexes, as the visited vertexes are kept in a 64-bit mask. */
+#define BRANCH_BOUND_MAX_VERTEXES 64
+
+/** Nodes with more vertexes left than this are split into tasks, smaller ones are searched in place. */
+#define BRANCH_BOUND_SPLIT 10
+
+/** Nodes a worker explores between two readings of the clock, to stop at the deadline. */
+#define BRANCH_BOUND_CHECK_NODES 4096
+
+/**
+ * Partial tour waiting to be searched.
+*/
+struct SearchNode {
+	/** Indexes of the tour so far, from the start vertex. */
+	std::vector<int> path;
+
+	/** Vertexes in the path, as bits of their local numbers. */
+	uint64_t visited;
+
+	/** Length of the path. */
+	double cost;
+};
+
+/**
+ * Tasks of a worker thread. The owner takes from the back, depth first,
+ * idle workers steal from the front, where the largest subtrees are.
+*/
+struct WorkQueue {
+	std::mutex lock;
+	std::deque<SearchNode> nodes;
+};
+
+/**
+ * State shared by the workers of a branch-and-bound search.
+*/
+struct BranchBoundSearch {
+	int n;
+	int start;
+
+	/** distances[i * n + j] = distance(i, j), INF if there is no edge. */
+	std::vector<double> distances;
+
+	/** Shortest distance between two vertexes in either direction, for the spanning tree bounds. */
+	std::vector<double> undirected;
+
+	/** Vertex penalties of the Lagrangian 1-tree bound, found once for the whole tour. */
+	std::vector<double> penalties;
+
+	/** True if every distance is the same both ways, which the penalized bound needs. */
+	bool symmetric;
+
+	/** For each vertex, the other vertexes by increasing distance from it. */
+	std::vector<int> nearest;
+
+	/** Length of the best tour found, read by every worker to prune. */
+	std::atomic<double> incumbent;
+	std::mutex bestLock;
+	std::vector<int> bestPath;
+	double bestLength;
+
+	std::vector<WorkQueue> queues;
+
+	/** Nodes queued or being split, the search ends when it reaches zero. */
+	std::atomic<long> pending;
+	std::atomic<size_t> explored;
+
+	/** Set once a worker leaves part of the tree unexplored because the control stopped it. */
+	std::atomic<bool> stopped;
+
+	/** Stops the workers, which then leave the rest of the tree unexplored. */
+	SolveControl &control;
+
+	/** Called with each shorter tour and its length, after bestLock is released. */
+	std::function<void(const std::vector<int>&, double)> improved;
+
+	BranchBoundSearch(int n, unsigned threads, SolveControl &control) : n(n), start(0), symmetric(true), 
+		incumbent(INF), bestLength(INF), queues(threads), pending(0), explored(0), 
+		stopped(false), control(control) {}
+
+	void findPenalties();
+	double spanningTree(const int *vertexes, int count, bool penalized) const;
+	double lowerBound(int last, uint64_t visited, double cost) const;
+	void offer(const std::vector<int> &path, double length);
+	void search(std::vector<int> &path, uint64_t visited, double cost, size_t &count);
+	void expand(const SearchNode &node, unsigned thread, size_t &count);
+	bool take(unsigned thread, SearchNode &node);
+	void work(unsigned thread);
+};
+
+/**
+ * Weight of the minimum spanning tree of some vertexes, by Prim's algorithm over
+ * the dense undirected distances.
+ * @param vertexes The vertexes. Reordered.
+ * @param count Number of vertexes.
+ * @param penalized If true, the penalties of both ends are added to each edge.
+ * @return Weight of the tree, INF if the vertexes are not connected.
+ * @note Complexity: O(count^2)
+*/
+double BranchBoundSearch::spanningTree(const int *vertexes, int count, bool penalized) const
+{
+	int order[BRANCH_BOUND_MAX_VERTEXES];
+	double key[BRANCH_BOUND_MAX_VERTEXES];
+	std::copy(vertexes, vertexes + count, order);
+	auto weight = [&](int u, int v) {
+		double w = undirected[(size_t)u * n + v];
+		return penalized && w != INF ? w + penalties[u] + penalties[v] : w;
+	};
+
+	double total = 0;
+	for (int i = 1; i < count; i++)
+		key[i] = weight(order[0], order[i]);
+	for (int size = count - 1; size > 0; size--)
+	{
+		// Move the closest vertex to the tree to the end of the ones left
+		int closest = 1;
+		for (int i = 2; i <= size; i++)
+			if (key[i] < key[closest]) closest = i;
+		if (key[closest] == INF) return INF;
+		total += key[closest];
+		int v = order[closest];
+		std::swap(order[closest], order[size]);
+		std::swap(key[closest], key[size]);
+		for (int i = 1; i < size; i++)
+			key[i] = std::min(key[i], weight(v, order[i]));
+	}
+	return total;
+}
+
+/**
+ * Finds vertex penalties that tighten the 1-tree bound, by subgradient ascent
+ * on the tour through every vertex (Held-Karp bound): each step raises the penalty
+ * of the vertexes whose degree in the 1-tree is above 2 and lowers the others,
+ * pushing the tree towards a tour. Steps are proportional to the gap between the bound
+ * and the length of the seed tour, and halved whenever the bound stops improving.
+ * The penalties with the highest bound are kept.
+ * @note Complexity: O(V^3)
+*/
+void BranchBoundSearch::findPenalties()
+{
+	penalties.assign(n, 0);
+	double upper = incumbent.load();
+	if (n < 4 || upper == INF) return;
+
+	std::vector<double> current(n, 0), key(n);
+	std::vector<int> parent(n), degree(n);
+	std::vector<bool> inTree(n);
+	double best = -INF, scale = 2;
+	int stalled = 0;
+	for (int iteration = 0; iteration < 10 * n && scale > 1e-3; iteration++)
+	{
+		// 1-tree: spanning tree of the vertexes but the start, plus its two shortest edges
+		auto weight = [&](int u, int v) {
+			double w = undirected[(size_t)u * n + v];
+			return w == INF ? INF : w + current[u] + current[v];
+		};
+		int root = start == 0 ? 1 : 0;
+		std::fill(inTree.begin(), inTree.end(), false);
+		std::fill(degree.begin(), degree.end(), 0);
+		std::fill(key.begin(), key.end(), INF);
+		key[root] = 0;
+		parent[root] = -1;
+		double bound = 0;
+		for (int added = 0; added < n - 1; added++)
+		{
+			int u = -1;
+			for (int v = 0; v < n; v++)
+				if (v != start && !inTree[v] && (u == -1 || key[v] < key[u])) u = v;
+			if (key[u] == INF) return;
+			inTree[u] = true;
+			bound += key[u];
+			if (parent[u] != -1) degree[u]++, degree[parent[u]]++;
+			for (int v = 0; v < n; v++)
+			{
+				if (v == start || inTree[v] || weight(u, v) >= key[v]) continue;
+				key[v] = weight(u, v);
+				parent[v] = u;
+			}
+		}
+		int first = -1, second = -1;
+		for (int v = 0; v < n; v++)
+		{
+			if (v == start) continue;
+			if (first == -1 || weight(start, v) < weight(start, first)) second = first, first = v;
+			else if (second == -1 || weight(start, v) < weight(start, second)) second = v;
+		}
+		if (weight(start, second) == INF) return;
+		bound += weight(start, first) + weight(start, second);
+		degree[first]++, degree[second]++, degree[start] = 2;
+		for (int v = 0; v < n; v++)
+			bound -= 2 * current[v];
+
+		if (bound > best)
+		{
+			best = bound;
+			penalties = current;
+			stalled = 0;
+		}
+		else if (++stalled == n / 2 + 1)
+		{
+			scale /= 2;
+			stalled = 0;
+		}
+
+		double norm = 0;
+		for (int v = 0; v < n; v++)
+			norm += (degree[v] - 2) * (degree[v] - 2);
+		if (norm == 0) return;
+		double step = scale * (upper - bound) / norm;
+		for (int v = 0; v < n; v++)
+			current[v] += step * (degree[v] - 2);
+	}
+}
+
+/**
+ * Lower bound on the length of any tour extending a path (1-tree bound).
+ * The rest of the tour leaves the last vertex, goes through all the remaining vertexes
+ * and returns to the start, so without its first and last edges it spans the remaining vertexes,
+ * and it is at least as long as their minimum spanning tree plus the shortest edges
+ * leaving the last vertex and reaching the start.
+ * On symmetric distances, the penalties of both ends are added to each edge,
+ * which adds twice the penalty of each remaining vertex to the length of the rest of the tour,
+ * as they all have two of its edges, so they are taken back from the bound.
+ * @param last Last vertex of the path.
+ * @param visited Vertexes of the path.
+ * @param cost Length of the path.
+ * @note Complexity: O(R^2), R being the number of remaining vertexes
+*/
+double BranchBoundSearch::lowerBound(int last, uint64_t visited, double cost) const
+{
+	int remaining[BRANCH_BOUND_MAX_VERTEXES];
+	int count = 0;
+	double leave = INF, back = INF, penalty = 0;
+	for (int v = 0; v < n; v++)
+	{
+		if (visited >> v & 1) continue;
+		remaining[count++] = v;
+		double to = distances[(size_t)last * n + v], from = distances[(size_t)v * n + start];
+		if (symmetric)
+		{
+			if (to != INF) to += penalties[v];
+			if (from != INF) from += penalties[v];
+			penalty += 2 * penalties[v];
+		}
+		leave = std::min(leave, to);
+		back = std::min(back, from);
+	}
+	if (count == 0) return cost + distances[(size_t)last * n + start];
+	if (leave == INF || back == INF) return INF;
+
+	// The penalties cancel out only up to rounding, which must not prune a shorter tour
+	double tree = spanningTree(remaining, count, symmetric);
+	if (tree == INF) return INF;
+	double bound = cost + leave + back + tree - penalty;
+	return symmetric ? bound - 1e-9 * std::abs(bound) : bound;
+}
+
+/**
+ * Records a complete tour if it is shorter than the best one found.
+ * The incumbent length is lowered first, so the other workers prune with it at once.
+ * @param path Tour, starting and ending at the start vertex.
+ * @param length Length of the tour.
+*/
+void BranchBoundSearch::offer(const std::vector<int> &path, double length)
+{
+	double current = incumbent.load();
+	while (length < current && !incumbent.compare_exchange_weak(current, length)) {}
+	if (length >= current) return;
+
+	{
+		std::lock_guard<std::mutex> guard(bestLock);
+		if (length >= bestLength) return;
+		bestLength = length;
+		bestPath = path;
+	}
+	if (improved) improved(path, length);
+}
+
+/**
+ * Depth-first search below a node, nearest vertexes first, on the calling thread.
+ * @param path Path so far, restored on return.
+ * @param visited Vertexes of the path.
+ * @param cost Length of the path.
+ * @param count Number of nodes explored by the thread.
+*/
+void BranchBoundSearch::search(std::vector<int> &path, uint64_t visited, double cost, size_t &count)
+{
+	if (++count % BRANCH_BOUND_CHECK_NODES == 0 ? control.check() : control.isStopped())
+	{
+		stopped = true;
+		return;
+	}
+	int last = path.back();
+	if ((int)path.size() == n)
+	{
+		double length = cost + distances[(size_t)last * n + start];
+		if (length < incumbent.load(std::memory_order_relaxed))
+		{
+			path.push_back(start);
+			offer(path, length);
+			path.pop_back();
+		}
+		return;
+	}
+	if (lowerBound(last, visited, cost) >= incumbent.load(std::memory_order_relaxed)) return;
+
+	for (int i = 0; i < n - 1; i++)
+	{
+		int v = nearest[(size_t)last * (n - 1) + i];
+		double weight = distances[(size_t)last * n + v];
+		if (visited >> v & 1 || weight == INF) continue;
+		path.push_back(v);
+		search(path, visited | (uint64_t)1 << v, cost + weight, count);
+		path.pop_back();
+	}
+}
+
+/**
+ * Splits a node with many vertexes left into a task per child,
+ * queued so that the nearest child is taken first.
+ * @param node Node to split.
+ * @param thread Worker whose queue gets the children.
+ * @param count Number of nodes explored by the thread.
+*/
+void BranchBoundSearch::expand(const SearchNode &node, unsigned thread, size_t &count)
+{
+	// Each split costs far more than reading the clock
+	count++;
+	if (control.check())
+	{
+		stopped = true;
+		return;
+	}
+	int last = node.path.back();
+	if (lowerBound(last, node.visited, node.cost) >= incumbent.load()) return;
+
+	std::vector<SearchNode> children;
+	for (int i = n - 2; i >= 0; i--)
+	{
+		int v = nearest[(size_t)last * (n - 1) + i];
+		double weight = distances[(size_t)last * n + v];
+		if (node.visited >> v & 1 || weight == INF) continue;
+		children.push_back({node.path, node.visited | (uint64_t)1 << v, node.cost + weight});
+		children.back().path.push_back(v);
+	}
+
+	pending += children.size();
+	std::lock_guard<std::mutex> guard(queues[thread].lock);
+	for (auto &child : children)
+		queues[thread].nodes.push_back(std::move(child));
+}
+
+/**
+ * Takes a task, from the back of the worker's own queue or else from the front of another's.
+ * @return False if every queue was empty.
+*/
+bool BranchBoundSearch::take(unsigned thread, SearchNode &node)
+{
+	for (size_t i = 0; i < queues.size(); i++)
+	{
+		WorkQueue &queue = queues[(thread + i) % queues.size()];
+		std::lock_guard<std::mutex> guard(queue.lock);
+		if (queue.nodes.empty()) continue;
+		if (i == 0)
+		{
+			node = std::move(queue.nodes.back());
+			queue.nodes.pop_back();
+		}
+		else
+		{
+			node = std::move(queue.nodes.front());
+			queue.nodes.pop_front();
+		}
+		return true;
+	}
+	return false;
+}
+
+/**
+ * Runs tasks until none is left in any queue nor being split, or the search is stopped.
+ * @param thread Index of the worker.
+*/
+void BranchBoundSearch::work(unsigned thread)
+{
+	size_t count = 0;
+	SearchNode node;
+	while (pending > 0 && !control.isStopped())
+	{
+		if (!take(thread, node))
+		{
+			std::this_thread::yield();
+			continue;
+		}
+		if (n - (int)node.path.size() > BRANCH_BOUND_SPLIT) expand(node, thread, count);
+		else search(node.path, node.visited, node.cost, count);
+		pending--;
+	}
+	explored += count;
+}
+
+/**
+ * Exact solver by branch and bound, starting at the vertex with id 0 like backtracking.
+ * The search starts with the triangular approximation tour as the best one, and
+ * prunes every path whose 1-tree lower bound is not below the best tour found.
+ * On symmetric distances, the bound uses vertex penalties found once at the root,
+ * which bring it within about a percent of the optimum.
+ * The search tree is split into tasks shared by worker threads with work stealing,
+ * and the length of the best tour is shared through an atomic so all of them prune with it.
+ * If the control stops the search, the best tour found so far is returned,
+ * which is at worst the seed.
+ * @param control Deadline, cancellation and callback of the run.
+ * @note Complexity: O(V!) in the worst case, usually far less thanks to the bounds.
+ * @return Structure with the time taken, stops, distances between stops, total distance
+ * travelled and number of search nodes explored.
+*/
+ReturnDataTSP Manager::branchAndBoundHeuristic(SolveControl &control) const
+{
+	auto startTime = std::chrono::high_resolution_clock::now();
+	int n = current.csr.getNumVertex();
+	int initial = current.csr.findIndex(0);
+	if (initial == -1 || n < 2 || n > BRANCH_BOUND_MAX_VERTEXES) return {-1, {}, {}, -1};
+
+	BranchBoundSearch search(n, getThreadCount(), control);
+	search.improved = [&](const std::vector<int> &path, double length) {
+		control.report(length, [&]() { return tourOf(path, control.elapsed()); });
+	};
+	search.start = initial;
+	search.distances.resize((size_t)n * n);
+	search.nearest.resize((size_t)n * (n - 1));
+	std::vector<double> row;
+	for (int i = 0; i < n; i++)
+	{
+		distanceRow(i, row);
+		std::copy(row.begin(), row.end(), search.distances.begin() + (size_t)i * n);
+		int *nearest = search.nearest.data() + (size_t)i * (n - 1);
+		for (int j = 0, k = 0; j < n; j++)
+			if (j != i) nearest[k++] = j;
+		std::sort(nearest, nearest + n - 1, [&](int a, int b) { return row[a] < row[b]; });
+	}
+	search.undirected.resize((size_t)n * n);
+	for (int i = 0; i < n; i++)
+	{
+		for (int j = 0; j < n; j++)
+		{
+			double there = search.distances[(size_t)i * n + j], back = search.distances[(size_t)j * n + i];
+			search.undirected[(size_t)i * n + j] = std::min(there, back);
+			if (there != back) search.symmetric = false;
+		}
+	}
+
+	// Seed the search with the triangular approximation, rotated to the start vertex
+	ReturnDataTSP seed = triangularApproximationHeuristic();
+	if (seed.stops.size() == (size_t)n + 1)
+	{
+		std::vector<int> tour;
+		for (size_t i = 0; i + 1 < seed.stops.size(); i++)
+			tour.push_back(current.csr.findIndex(seed.stops[i]));
+		std::rotate(tour.begin(), std::find(tour.begin(), tour.end(), initial), tour.end());
+		tour.push_back(initial);
+		double length = 0;
+		for (int i = 0; i < n; i++)
+			length += search.distances[(size_t)tour[i] * n + tour[i + 1]];
+		if (length < INF) search.offer(tour, length);
+	}
+
+	if (search.symmetric) search.findPenalties();
+
+	search.pending = 1;
+	search.queues[0].nodes.push_back({{initial}, (uint64_t)1 << initial, 0});
+	parallelFor(0, search.queues.size(), [&](size_t thread, unsigned) {
+		search.work(thread);
+	}, search.queues.size());
+
+	// Nodes left in the queues were never searched, and a search cut short
+	// may have already brought the count down to zero
+	if (search.pending > 0) search.stopped = true;
+
+	if (search.bestLength == INF)
+	{
+		ReturnDataTSP result = {-2, {}, {}, -2};
+		result.interrupted = search.stopped;
+		return result;
+	}
+
+	auto end = std::chrono::high_resolution_clock::now();
+	ReturnDataTSP result = tourOf(search.bestPath, std::chrono::duration<double>(end - startTime).count());
+	result.exploredNodes = search.explored;
+	result.interrupted = search.stopped;
+	return result;
+}
@@ -0,0 +1,290 @@
+#include "../manager.h"
+
+#if defined(__GNUC__) && !defined(__clang__) && defined(__linux__) && defined(__x86_64__)
+# define HELD_KARP_KERNEL __attribute__((target_clones("avx512f", "avx2", "default")))
+#else
+# define HELD_KARP_KERNEL
+#endif
+
+/** Largest number of vertexes, as subsets of the other vertexes are 32-bit masks. */
+#define HELD_KARP_MAX_VERTEXES 32
+
+/** Row length of the table of binomial coefficients. */
+#define HELD_KARP_BINOMIALS 33
+
+/** Number of subsets of a layer given to a thread at a time. */
+#define HELD_KARP_CHUNK 4096
+
+/**
+ * Next subset with the same number of vertexes, in increasing order (Gosper's hack).
+*/
+static inline uint32_t nextSubset(uint32_t s)
+{
+	uint32_t lowest = s & -s;
+	uint32_t ripple = s + lowest;
+	return (((ripple ^ s) >> 2) / lowest) | ripple;
+}
+
+/**
+ * Smallest value of values[r] + costs[r] over r, 
+ * written as a plain loop so that it is vectorized.
+*/
+template <typename T>
+static inline __attribute__((always_inline)) T minSum(const T *values, const T *costs, int count)
+{
+	T best = std::numeric_limits<T>::max();
+	for (int r = 0; r < count; r++)
+		best = std::min(best, values[r] + costs[r]);
+	return best;
+}
+
+/**
+ * Fills the entries of a subset S of k vertexes from the entries of its subsets of k - 1.
+ * The rank of a subset among those of its size, in increasing order, is the sum of 
+ * binomial(e_t, t + 1) over its vertexes e_0 < e_1 < ..., so the rank of S \ {e_p}
+ * is that sum before p plus the sum of binomial(e_t, t) after p.
+ * The vertexes of S \ {e_p} are those of S without position p,
+ * so the minimum is taken over the positions before and after p.
+ * @param entry Entries of S.
+ * @param previousLayer Entries of the subsets of k - 1 vertexes.
+*/
+template <typename T>
+static inline __attribute__((always_inline)) void solveSubset(T *entry, const T *previousLayer, 
+	const T *costs, const uint64_t *binomial, int m, uint32_t s, int k)
+{
+	int elements[32];
+	uint64_t after[33];
+	T column[32];
+	int size = 0;
+	for (uint32_t bits = s; bits; bits &= bits - 1)
+		elements[size++] = __builtin_ctz(bits);
+	after[k] = 0;
+	for (int t = k - 1; t >= 0; t--)
+		after[t] = after[t + 1] + binomial[elements[t] * HELD_KARP_BINOMIALS + t];
+
+	uint64_t before = 0;
+	for (int p = 0; p < k; p++)
+	{
+		int j = elements[p];
+		const T *previous = previousLayer + (before + after[p + 1]) * (k - 1);
+		const T *costsTo = costs + (size_t)j * m;
+		for (int q = 0; q < k; q++)
+			column[q] = costsTo[elements[q]];
+		entry[p] = std::min(minSum(previous, column, p), 
+			minSum(previous + p, column + p + 1, k - 1 - p));
+		before += binomial[j * HELD_KARP_BINOMIALS + p + 1];
+	}
+}
+
+/**
+ * Solves a range of consecutive subsets of a layer, given by its first subset.
+ * Compiled for each instruction set.
+*/
+HELD_KARP_KERNEL
+static void solveSubsets(double *entries, const double *previousLayer, const double *costs, 
+	const uint64_t *binomial, int m, uint32_t s, int k, uint64_t count)
+{
+	for (uint64_t r = 0; r < count; r++, s = nextSubset(s), entries += k)
+		solveSubset(entries, previousLayer, costs, binomial, m, s, k);
+}
+
+/**
+ * Estimates the memory used by the Held-Karp solver on the current graph:
+ * a value for each (subset, last vertex) pair, in double precision.
+ * @return Bytes needed, or the largest size_t if the graph is too large for the solver.
+*/
+size_t Manager::getHeldKarpMemory() const
+{
+	int n = current.csr.getNumVertex();
+	if (n > HELD_KARP_MAX_VERTEXES) return std::numeric_limits<size_t>::max();
+	if (n < 2) return 0;
+	int m = n - 1;
+	size_t entries = (size_t)m << (m - 1);
+	return (entries + (size_t)m * m) * sizeof(double);
+}
+
+/**
+ * Bitmask dynamic programming over subsets (Held-Karp).
+ * The vertexes other than the start are numbered 0 to m - 1. For every subset S
+ * of them and every j in S, the table keeps the length of the shortest path
+ * leaving the start, going through all of S and ending at j.
+ * The table is compact: a subset of k vertexes only has k entries, in the order of
+ * its vertexes, and subsets are stored layer by layer, by number of vertexes.
+ * Each layer only reads the previous one, so its subsets are solved in parallel.
+ * Missing edges cost a large finite value, so the minimums can be vectorized.
+ * @param start Index of the vertex where the tour starts and ends.
+ * @param order Filled with the indexes of the tour, starting and ending at start.
+ * @param control Stops the solver between chunks of subsets.
+ * @return Length of the tour, or -1 if there is none
+ * or the solver was stopped, as no tour is known before the last layer.
+ * @note Complexity: O(2^V V^2) time, O(2^V V) memory
+*/
+double Manager::heldKarp(int start, std::vector<int> &order, SolveControl &control) const
+{
+	int n = current.csr.getNumVertex();
+	int m = n - 1;
+	const double missing = std::numeric_limits<double>::max() / 64;
+	std::unique_ptr<double[]> values;
+
+	// Vertex numbering without the start, and costs[j * m + i] = distance(i, j)
+	std::vector<int> vertexes;
+	for (int v = 0; v < n; v++)
+		if (v != start) vertexes.push_back(v);
+	std::vector<double> costs((size_t)m * m), fromStart(m), toStart(m);
+	std::vector<double> row;
+	for (int i = 0; i < m; i++)
+	{
+		distanceRow(vertexes[i], row);
+		for (int j = 0; j < m; j++)
+			costs[(size_t)j * m + i] = row[vertexes[j]] == INF ? missing : row[vertexes[j]];
+		toStart[i] = row[start] == INF ? missing : row[start];
+	}
+	distanceRow(start, row);
+	for (int j = 0; j < m; j++)
+		fromStart[j] = row[vertexes[j]] == INF ? missing : row[vertexes[j]];
+
+	// Binomial coefficients, to rank subsets and find the subset a chunk of a layer starts at
+	std::vector<uint64_t> binomial(HELD_KARP_BINOMIALS * HELD_KARP_BINOMIALS, 0);
+	auto choose = [&](int a, int b) -> uint64_t& { return binomial[a * HELD_KARP_BINOMIALS + b]; };
+	for (int a = 0; a <= m; a++)
+	{
+		choose(a, 0) = 1;
+		for (int b = 1; b <= a; b++)
+			choose(a, b) = choose(a - 1, b - 1) + choose(a - 1, b);
+	}
+
+	// Subsets are stored layer by layer, in increasing order within a layer
+	std::vector<size_t> layers(m + 2, 0);
+	for (int k = 1; k <= m; k++)
+		layers[k + 1] = layers[k] + choose(m, k) * k;
+	auto subsetAt = [&](int k, uint64_t rank) {
+		uint32_t s = 0;
+		for (int b = k; b > 0; b--)
+		{
+			int c = b - 1;
+			while (c + 1 < m && choose(c + 1, b) <= rank) c++;
+			s |= 1u << c;
+			rank -= choose(c, b);
+		}
+		return s;
+	};
+	auto entriesOf = [&](uint32_t s) {
+		int k = 0;
+		uint64_t rank = 0;
+		for (uint32_t bits = s; bits; bits &= bits - 1, k++)
+			rank += choose(__builtin_ctz(bits), k + 1);
+		return values.get() + layers[k] + rank * k;
+	};
+
+	// Every entry is written before it is read, so the table is not zeroed first,
+	// and its pages are only touched layer by layer, where the control is checked
+	if (control.check()) return -1;
+	values.reset(new double[layers[m + 1]]);
+
+	// Single vertexes are reached straight from the start
+	std::copy(fromStart.begin(), fromStart.end(), values.get());
+
+	for (int k = 2; k <= m; k++)
+	{
+		uint64_t count = choose(m, k);
+		size_t chunks = (count + HELD_KARP_CHUNK - 1) / HELD_KARP_CHUNK;
+		parallelFor(0, chunks, [&](size_t chunk, unsigned) {
+			if (control.check()) return;
+			uint64_t first = chunk * HELD_KARP_CHUNK;
+			uint64_t size = std::min<uint64_t>(HELD_KARP_CHUNK, count - first);
+			solveSubsets(values.get() + layers[k] + first * k, values.get() + layers[k - 1], 
+				costs.data(), binomial.data(), m, subsetAt(k, first), k, size);
+		}, 0);
+		if (control.isStopped()) return -1;
+	}
+
+	// Close the tour
+	uint32_t all = (uint32_t)(((uint64_t)1 << m) - 1);
+	const double *last = entriesOf(all);
+	double best = std::numeric_limits<double>::max();
+	int end = -1;
+	for (int j = 0; j < m; j++)
+	{
+		if (last[j] + toStart[j] < best)
+		{
+			best = last[j] + toStart[j];
+			end = j;
+		}
+	}
+
+	// The vertex before j is the one whose entry gives exactly the value of j,
+	// as it is computed again with the same operations. Should the kernel round differently,
+	// the one giving the smallest value is taken, so every step still removes a vertex
+	order.assign(1, start);
+	for (uint32_t s = all; s != 0; )
+	{
+		order.push_back(vertexes[end]);
+		double value = entriesOf(s)[__builtin_popcount(s & ((1u << end) - 1))];
+		s ^= 1u << end;
+		const double *previous = entriesOf(s);
+		int position = 0, closest = -1;
+		double closestValue = std::numeric_limits<double>::max();
+		for (uint32_t bits = s; bits; bits &= bits - 1, position++)
+		{
+			int i = __builtin_ctz(bits);
+			double candidate = previous[position] + costs[(size_t)end * m + i];
+			if (candidate == value)
+			{
+				closest = i;
+				break;
+			}
+			if (candidate < closestValue)
+			{
+				closestValue = candidate;
+				closest = i;
+			}
+		}
+		if (closest != -1) end = closest;
+	}
+	order.push_back(start);
+	std::reverse(order.begin(), order.end());
+	return best >= missing ? -1 : best;
+}
+
+/**
+ * Exact solver, by dynamic programming over the subsets of vertexes (Held-Karp).
+ * Starts at the vertex with id 0, like backtracking, and finds the same optimal tour
+ * in O(2^V V^2) instead of O(V!), so graphs of about 25 vertexes are solved in seconds.
+ * Tours using a missing edge are not valid.
+ * The solver only knows a tour at the very end, so if the control stops it,
+ * no tour is returned and the run is marked as interrupted.
+ * @param control Deadline, cancellation and callback of the run.
+ * @note Complexity: O(2^V V^2)
+ * @return Structure with the time taken, stops, distances between stops and total distance travelled.
+*/
+ReturnDataTSP Manager::heldKarpHeuristic(SolveControl &control) const
+{
+	auto start = std::chrono::high_resolution_clock::now();
+	int initial = current.csr.findIndex(0);
+	int n = current.csr.getNumVertex();
+	if (initial == -1 || n < 2 || getHeldKarpMemory() > HELD_KARP_MAX_MEMORY) return {-1, {}, {}, -1};
+
+	std::vector<int> order;
+	double length = heldKarp(initial, order, control);
+	if (length < 0 && control.isStopped())
+	{
+		ReturnDataTSP result = {-1, {}, {}, -1};
+		result.interrupted = true;
+		return result;
+	}
+	if (length < 0) return {-2, {}, {}, -2};
+
+	std::vector<int> stops;
+	std::vector<double> distances;
+	double totalDistance = 0;
+	for (size_t i = 0; i < order.size(); i++)
+	{
+		stops.push_back(current.csr.getId(order[i]));
+		if (i == 0) continue;
+		distances.push_back(distance(order[i - 1], order[i]));
+		totalDistance += distances.back();
+	}
+
+	auto end = std::chrono::high_resolution_clock::now();
+	return {std::chrono::duration<double>(end - start).count(), stops, distances, totalDistance};
+}
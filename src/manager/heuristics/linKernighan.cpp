@@ -0,0 +1,609 @@
+#include "../manager.h"
+#include "../../graph/tour.h"
+#include <deque>
+#include <numeric>
+#include <random>
+
+/** Candidate neighbours per vertex, by alpha-nearness. */
+#define LK_CANDIDATES 5
+
+/** Largest number of flips of a move, so moves are up to 5-opt. */
+#define LK_MAX_DEPTH 4
+
+/** Seconds the kicks may run for. */
+#define LK_TIME_LIMIT 2.0
+
+/** Kicks tried per vertex, at most. */
+#define LK_KICKS_PER_VERTEX 20
+
+/** Kicks after each start of the multi-start solver, per vertex. */
+#define MULTI_START_KICKS_PER_VERTEX 1
+
+/** Longest segment swapped by a kick. */
+#define LK_KICK_SEGMENT 50
+
+/** Improvements smaller than this fraction of the average tour edge are ignored, as rounding noise. */
+#define LK_EPSILON 1e-9
+
+/** Smallest tour kept as a two-level list, smaller ones are flipped faster in an array. */
+#define TWO_LEVEL_TOUR_MIN_VERTEXES 2000
+
+/** Candidates tried at each depth of a move, the deeper ones only try the best. */
+static const int LK_BREADTH[LK_MAX_DEPTH] = {5, 3, 1, 1};
+
+/**
+ * Lists the best candidate neighbours of every vertex by alpha-nearness: the increase
+ * in length of the minimum spanning tree when it is forced to contain the edge.
+ * That is the edge weight minus the heaviest edge on the tree path between both ends,
+ * so the edges of the tree have alpha 0, and the edges of optimal tours tend to be
+ * among the few nearest by alpha. Ties are broken by distance.
+ * The heaviest edges on the paths from a vertex to all others are found in one pass
+ * over the tree in topological order, from the path up to the root.
+ * @param k Number of candidates per vertex.
+ * @return Flat list where the candidates of vertex v are at [v * k, (v + 1) * k),
+ * best first, -1 past the vertexes it has an edge to.
+ * @note Complexity: O(V^2)
+*/
+std::vector<int> Manager::alphaCandidates(int k) const
+{
+	int n = current.csr.getNumVertex();
+	SpanningTree tree = current.implicitlyCompleted ? PrimMSTComplete(0) : PrimMST(current.csr, 0);
+
+	// Parents before children
+	std::vector<int> topological;
+	for (int v = 0; v < n; v++)
+		if (tree.parent[v] == -1) topological.push_back(v);
+	for (size_t i = 0; i < topological.size(); i++)
+		for (int c = tree.childBegin[topological[i]]; c < tree.childBegin[topological[i] + 1]; c++)
+			topological.push_back(tree.children[c]);
+
+	std::vector<int> lists((size_t)n * k, -1);
+	unsigned threads = getThreadCount();
+	std::vector<std::vector<double>> betas(threads, std::vector<double>(n)), rows(threads), alphas(threads);
+	std::vector<std::vector<int>> marks(threads, std::vector<int>(n, -1)), orders(threads);
+	parallelFor(0, n, [&](size_t i, unsigned thread) {
+		std::vector<double> &beta = betas[thread], &row = rows[thread], &alpha = alphas[thread];
+		std::vector<int> &mark = marks[thread], &order = orders[thread];
+
+		// Heaviest edges from i up to its root, then down to every other vertex
+		beta[i] = 0;
+		mark[i] = i;
+		for (int v = i; tree.parent[v] != -1; v = tree.parent[v])
+		{
+			beta[tree.parent[v]] = std::max(beta[v], tree.weight[v]);
+			mark[tree.parent[v]] = i;
+		}
+		for (int v : topological)
+		{
+			if (mark[v] == (int)i) continue;
+			beta[v] = tree.parent[v] == -1 ? 0 : std::max(beta[tree.parent[v]], tree.weight[v]);
+		}
+
+		distanceRow(i, row);
+		alpha.resize(n);
+		order.clear();
+		for (int j = 0; j < n; j++)
+		{
+			if (j == (int)i || row[j] == INF) continue;
+			alpha[j] = row[j] - beta[j];
+			order.push_back(j);
+		}
+		size_t count = std::min<size_t>(k, order.size());
+		std::partial_sort(order.begin(), order.begin() + count, order.end(), [&](int a, int b) {
+			if (alpha[a] != alpha[b]) return alpha[a] < alpha[b];
+			return row[a] < row[b] || (row[a] == row[b] && a < b);
+		});
+		std::copy(order.begin(), order.begin() + count, lists.begin() + i * k);
+	}, threads, 16);
+	return lists;
+}
+
+/**
+ * Lin-Kernighan local search on a tour, with the moves made of flips:
+ * the edge from t1 to t2 is removed, t2 is joined to a candidate t3, and the edge from
+ * t3 to its t4 is removed, so that joining t4 back to t1 closes the tour again (a 2-opt move).
+ * Instead of closing it, the search may go on from t4 as the new t2, so a move of d flips
+ * is a sequential (d + 1)-opt move. Every step must keep the sum of the removed edges
+ * above the sum of the added ones, and the move is applied as soon as closing the tour improves it.
+ * The flips are also logged, so the moves since the last kick can be undone.
+ * The search stops early, with the best tour so far, if the control stops the run.
+*/
+template <typename Tour, typename Distance>
+struct LinKernighan {
+	Tour &tour;
+	Distance distance;
+	const std::vector<int> &candidates;
+	int k;
+	double epsilon;
+	double length;
+
+	std::vector<bool> queued;
+	std::deque<int> queue;
+	std::vector<std::pair<int, int>> flips;
+	size_t moves = 0;
+
+	SolveControl &control;
+
+	/** Called each time the best tour improves, once it is in the tour. */
+	std::function<void()> improved;
+
+	LinKernighan(Tour &tour, Distance distance, const std::vector<int> &candidates, int k, double length,
+		SolveControl &control)
+		: tour(tour), distance(distance), candidates(candidates), k(k),
+		epsilon(LK_EPSILON * length / tour.size()), length(length), queued(tour.size(), false), control(control)
+	{
+		for (int v = 0; v < tour.size(); v++)
+			activate(v);
+	}
+
+	void activate(int v)
+	{
+		if (queued[v]) return;
+		queued[v] = true;
+		queue.push_back(v);
+	}
+
+	int succ(int v, bool forward) const { return forward ? tour.next(v) : tour.prev(v); }
+	int pred(int v, bool forward) const { return forward ? tour.prev(v) : tour.next(v); }
+
+	/**
+	 * Reverses the path from a to b, going forward or backward.
+	*/
+	void flip(int a, int b, bool forward)
+	{
+		if (!forward) std::swap(a, b);
+		tour.flip(a, b);
+		flips.push_back({a, b});
+	}
+
+	/**
+	 * Undoes the flips made after the first count ones.
+	*/
+	void undo(size_t count)
+	{
+		while (flips.size() > count)
+		{
+			tour.flip(flips.back().second, flips.back().first);
+			flips.pop_back();
+		}
+	}
+
+	bool step(int t1, int t2, double gain, int depth, bool forward);
+	bool improve(int t1);
+	bool optimize(std::chrono::high_resolution_clock::time_point deadline);
+	double kick(std::mt19937 &random);
+	void iterate(std::chrono::high_resolution_clock::time_point start,
+		std::chrono::high_resolution_clock::time_point descentDeadline,
+		std::chrono::high_resolution_clock::time_point deadline, size_t maxKicks, unsigned seed,
+		std::vector<std::pair<double, double>> &convergence);
+};
+
+/**
+ * Extends a move whose last removed edge goes from t1 to t2, where t2 follows t1.
+ * @param gain Sum of the removed edges minus the sum of the added ones so far.
+ * @param forward Direction of the tour the move is built in.
+ * @return True if an improving move was found and applied.
+*/
+template <typename Tour, typename Distance>
+bool LinKernighan<Tour, Distance>::step(int t1, int t2, double gain, int depth, bool forward)
+{
+	int tried = 0;
+	for (int i = 0; i < k && tried < LK_BREADTH[depth - 1]; i++)
+	{
+		int t3 = candidates[(size_t)t2 * k + i];
+		if (t3 == -1) break;
+		if (t3 == succ(t2, forward) || t3 == pred(t2, forward)) continue;
+		double joined = gain - distance(t2, t3);
+		if (joined <= epsilon) continue;
+		tried++;
+
+		// t4 comes right before t3, so flipping the path from t2 to t4 joins t2 to t3 and t4 to t1
+		int t4 = pred(t3, forward);
+		double removed = joined + distance(t3, t4);
+		double closed = distance(t4, t1);
+		size_t mark = flips.size();
+		flip(t2, t4, forward);
+
+		if (removed - closed > epsilon)
+		{
+			length -= removed - closed;
+			activate(t1), activate(t2), activate(t3), activate(t4);
+			moves++;
+			return true;
+		}
+		if (depth < LK_MAX_DEPTH && step(t1, t4, removed, depth + 1, forward))
+		{
+			activate(t2), activate(t3);
+			return true;
+		}
+		undo(mark);
+	}
+	return false;
+}
+
+/**
+ * Tries the moves removing one of the edges of t1.
+ * @return True if an improving move was applied.
+*/
+template <typename Tour, typename Distance>
+bool LinKernighan<Tour, Distance>::improve(int t1)
+{
+	for (bool forward : {true, false})
+	{
+		int t2 = succ(t1, forward);
+		if (step(t1, t2, distance(t1, t2), 1, forward)) return true;
+	}
+	return false;
+}
+
+/**
+ * Applies improving moves from the queued vertexes until none is left.
+ * A vertex is queued again only when a move changes one of its edges (don't-look bits).
+ * @return False if the deadline was reached or the control stopped the run first.
+*/
+template <typename Tour, typename Distance>
+bool LinKernighan<Tour, Distance>::optimize(std::chrono::high_resolution_clock::time_point deadline)
+{
+	for (size_t steps = 0; !queue.empty(); steps++)
+	{
+		if (steps % 64 == 0 && (std::chrono::high_resolution_clock::now() > deadline || control.check())) return false;
+		int t1 = queue.front();
+		queue.pop_front();
+		queued[t1] = false;
+		if (improve(t1)) activate(t1);
+	}
+	return true;
+}
+
+/**
+ * Perturbs the tour with a double-bridge move between two short consecutive segments:
+ * a, B, C, w becomes a, C, B, w without reversing them, which no sequence of improving
+ * flips undoes easily. The segments are short, so the search after it stays local.
+ * @return Change of length.
+*/
+template <typename Tour, typename Distance>
+double LinKernighan<Tour, Distance>::kick(std::mt19937 &random)
+{
+	int n = tour.size();
+	int longest = std::min(LK_KICK_SEGMENT, (n - 2) / 2);
+	std::uniform_int_distribution<int> vertex(0, n - 1), segment(1, longest);
+	int a = vertex(random);
+	int firstB = tour.next(a), lastB = firstB;
+	for (int i = segment(random); i > 1; i--)
+		lastB = tour.next(lastB);
+	int firstC = tour.next(lastB), lastC = firstC;
+	for (int i = segment(random); i > 1; i--)
+		lastC = tour.next(lastC);
+	int w = tour.next(lastC);
+
+	double delta = distance(a, firstC) + distance(lastC, firstB) + distance(lastB, w)
+		- distance(a, firstB) - distance(lastB, firstC) - distance(lastC, w);
+	flip(firstB, lastC, true);
+	flip(lastC, firstC, true);
+	flip(lastB, firstB, true);
+	for (int v : {a, firstB, lastB, firstC, lastC, w})
+		activate(v);
+	length += delta;
+	return delta;
+}
+
+/**
+ * Brings the tour to a local optimum, then kicks it until the deadline or the last kick.
+ * A kick is kept if the tour ends up shorter, and undone otherwise.
+ * If the control stops the run, the best tour so far is left in the tour.
+ * @param start Time the heuristic started at.
+ * @param descentDeadline Time the first local search stops at, leaving the moves applied so far.
+ * @param deadline Time after which no more kicks are made.
+ * @param seed Seed of the random kicks.
+ * @param convergence Filled with the time since the start and the length of the best tour,
+ * each time it improves.
+*/
+template <typename Tour, typename Distance>
+void LinKernighan<Tour, Distance>::iterate(std::chrono::high_resolution_clock::time_point start,
+	std::chrono::high_resolution_clock::time_point descentDeadline,
+	std::chrono::high_resolution_clock::time_point deadline, size_t maxKicks, unsigned seed,
+	std::vector<std::pair<double, double>> &convergence)
+{
+	auto elapsed = [&]() {
+		return std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - start).count();
+	};
+
+	// Stopping the first local search early still leaves every applied move in the tour
+	optimize(descentDeadline);
+	flips.clear();
+	double best = length;
+	convergence.push_back({elapsed(), best});
+	if (improved) improved();
+
+	std::mt19937 random(seed);
+	size_t kicks = tour.size() >= 8 ? maxKicks : 0;
+	for (size_t kick = 0; kick < kicks && std::chrono::high_resolution_clock::now() < deadline
+		&& !control.check(); kick++)
+	{
+		size_t kept = moves;
+		this->kick(random);
+		bool finished = optimize(deadline);
+		if (finished && length < best - epsilon)
+		{
+			best = length;
+			convergence.push_back({elapsed(), best});
+			if (improved) improved();
+		}
+		else
+		{
+			undo(0);
+			length = best;
+			moves = kept;
+			queue.clear();
+			std::fill(queued.begin(), queued.end(), false);
+		}
+		flips.clear();
+	}
+}
+
+/**
+ * Iterated Lin-Kernighan. The tour of the triangular approximation is brought to a local
+ * optimum of moves of up to 5 edges, then kicked with random double-bridge moves, each
+ * followed by the local search again. A kick is kept if the tour ends up shorter,
+ * and undone otherwise. Candidates are the 5 best neighbours by alpha-nearness.
+ * The flips need symmetric distances, so on directed graphs only the Or-opt
+ * local search is applied instead.
+ * @param timeLimit Seconds the kicks may run for, the first local optimum is always reached.
+ * @param maxKicks Maximum number of kicks.
+ * @param control Stops the search at any point, even before the first local optimum.
+ * Each improvement of the best tour is reported to it.
+ * @return Structure with the time taken, stops, distances between stops and total distance travelled.
+ * The length of the starting tour, the improving moves, and the length of the best tour
+ * each time it improved are also returned.
+ * @note Complexity: O(V^2) for the candidates, then O(V) per flip, O(sqrt(V)) amortized from 2000 vertexes
+*/
+ReturnDataTSP Manager::iteratedLinKernighan(double timeLimit, size_t maxKicks, SolveControl &control) const
+{
+	auto start = std::chrono::high_resolution_clock::now();
+	ReturnDataTSP initial = triangularApproximationHeuristic();
+	int n = current.csr.getNumVertex();
+	if (initial.stops.size() != (size_t)n + 1) return {-1, {}, {}, -1};
+	if (n < 5 || !hasSymmetricDistances())
+	{
+		// The local search only has a time limit, so it gets the time left before the deadline
+		if (control.getDeadline() != SolveControl::Clock::time_point::max())
+			timeLimit = std::max(0.0, std::min(timeLimit, 
+				std::chrono::duration<double>(control.getDeadline() - SolveControl::Clock::now()).count()));
+		ReturnDataTSP result = improveTour(initial, timeLimit);
+		result.processingTime = std::chrono::duration<double>(
+			std::chrono::high_resolution_clock::now() - start).count();
+		return result;
+	}
+
+	std::vector<int> order;
+	double length = 0;
+	for (int i = 0; i < n; i++)
+	{
+		order.push_back(current.csr.findIndex(initial.stops[i]));
+		length += distance(current.csr.findIndex(initial.stops[i]), current.csr.findIndex(initial.stops[i + 1]));
+	}
+	if (length >= INF) return {-2, {}, {}, -2};
+	double startLength = length;
+
+	int k = std::min(LK_CANDIDATES, n - 1);
+	std::vector<int> candidates = alphaCandidates(k);
+	auto deadline = start + std::chrono::duration_cast<std::chrono::high_resolution_clock::duration>(
+		std::chrono::duration<double>(timeLimit));
+	auto dist = [this](int u, int v) { return distance(u, v); };
+	std::vector<std::pair<double, double>> convergence;
+	size_t moves = 0;
+
+	// Same start as the triangular approximation
+	int first = current.csr.findIndex(initial.stops.front());
+	auto search = [&](auto &tour) {
+		LinKernighan<std::decay_t<decltype(tour)>, decltype(dist)> lk(tour, dist, candidates, k, length, control);
+		lk.improved = [&]() {
+			control.report(lk.length, [&]() {
+				std::vector<int> closed = tour.vertexes(first);
+				closed.push_back(first);
+				return tourOf(closed, control.elapsed());
+			});
+		};
+		lk.iterate(start, std::chrono::high_resolution_clock::time_point::max(), deadline, 
+			maxKicks, n, convergence);
+		moves = lk.moves;
+		order = tour.vertexes(first);
+	};
+	if (n >= TWO_LEVEL_TOUR_MIN_VERTEXES)
+	{
+		TwoLevelTour tour(order);
+		search(tour);
+	}
+	else
+	{
+		ArrayTour tour(order);
+		search(tour);
+	}
+	order.push_back(order.front());
+
+	auto end = std::chrono::high_resolution_clock::now();
+	ReturnDataTSP result = tourOf(order, std::chrono::duration<double>(end - start).count());
+	result.initialDistance = startLength;
+	result.improvingMoves = moves;
+	result.improvementTime = result.processingTime;
+	result.convergence = convergence;
+	result.interrupted = control.isStopped();
+	return result;
+}
+
+/**
+ * Iterated Lin-Kernighan with the default budget: 2 seconds of kicks, and at most 20 per vertex.
+ * @param control Deadline, cancellation and callback of the run.
+ * @return Structure with the time taken, stops, distances between stops and total distance travelled.
+ * @note Complexity: O(V^2) for the candidates, then O(V) per flip, O(sqrt(V)) amortized from 2000 vertexes
+*/
+ReturnDataTSP Manager::linKernighanHeuristic(SolveControl &control) const
+{
+	return iteratedLinKernighan(LK_TIME_LIMIT, (size_t)current.csr.getNumVertex() * LK_KICKS_PER_VERTEX, control);
+}
+
+/**
+ * Tour visiting the vertexes in the preorder of a spanning tree from a random root,
+ * going down to the children in random order, like the triangular approximation.
+ * The neighbours of each vertex are read from the parent and child arrays of the tree.
+ * @return Vertex indexes, fewer than V if the tree does not reach them all.
+ * @note Complexity: O(V)
+*/
+static std::vector<int> randomTreeTour(const SpanningTree &mst, std::mt19937 &random)
+{
+	int n = mst.parent.size();
+	std::vector<int> order, stack = {std::uniform_int_distribution<int>(0, n - 1)(random)}, children;
+	std::vector<bool> visited(n, false);
+	visited[stack.back()] = true;
+	while (!stack.empty())
+	{
+		int v = stack.back();
+		stack.pop_back();
+		order.push_back(v);
+		children.clear();
+		mst.forEachNeighbour(v, [&](int u, double) {
+			if (!visited[u]) children.push_back(u);
+		});
+		std::shuffle(children.begin(), children.end(), random);
+		for (int child : children)
+		{
+			visited[child] = true;
+			stack.push_back(child);
+		}
+	}
+	return order;
+}
+
+/**
+ * Multi-start Lin-Kernighan. Each thread repeatedly builds a tour from the spanning tree
+ * with a random root and order of children, brings it to a local optimum and kicks it
+ * for a while, until the time runs out. The shortest tour of all threads is kept.
+ * The threads only share the read-only network, its spanning tree and the candidates,
+ * and take a lock only when they find a better tour.
+ * Tours using a missing edge are discarded. On directed graphs the flips cannot be used,
+ * so iterated Lin-Kernighan falls back to its Or-opt local search instead.
+ * @param threads Number of threads, 0 meaning getThreadCount().
+ * @param timeLimit Seconds after which the starts stop, even before their first local optimum.
+ * @param control Stops every thread at any point, keeping the best tour so far.
+ * Each improvement of the best tour of all threads is reported to it.
+ * @return Structure with the time taken, stops, distances between stops and total distance travelled.
+ * The length of the best tour each time it improved and the starts per second of each thread
+ * are also returned.
+ * @note Complexity: O(V^2) for the candidates, then the local searches split between the threads
+*/
+ReturnDataTSP Manager::multiStartLinKernighan(unsigned threads, double timeLimit, SolveControl &control) const
+{
+	auto start = std::chrono::high_resolution_clock::now();
+	int n = current.csr.getNumVertex();
+	if (n < 8 || !hasSymmetricDistances()) 
+		return iteratedLinKernighan(timeLimit, (size_t)n * LK_KICKS_PER_VERTEX, control);
+	if (threads == 0) threads = getThreadCount();
+
+	std::shared_ptr<const SpanningTree> mst = networkMST(0);
+	int k = std::min(LK_CANDIDATES, n - 1);
+	std::vector<int> candidates = alphaCandidates(k);
+	auto deadline = start + std::chrono::duration_cast<std::chrono::high_resolution_clock::duration>(
+		std::chrono::duration<double>(timeLimit));
+	auto dist = [this](int u, int v) { return distance(u, v); };
+	auto elapsed = [&]() {
+		return std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - start).count();
+	};
+
+	std::mutex bestMutex;
+	double best = INF;
+	std::vector<int> bestOrder;
+	std::vector<std::pair<double, double>> convergence;
+	std::vector<double> startsPerSecond(threads);
+
+	parallelFor(0, threads, [&](size_t worker, unsigned) {
+		auto workerStart = std::chrono::high_resolution_clock::now();
+		std::mt19937 random(n * threads + worker);
+		size_t starts = 0;
+		do
+		{
+			std::vector<int> order = randomTreeTour(*mst, random);
+			if (order.size() != (size_t)n) break;
+			double length = 0;
+			for (int i = 0; i < n; i++)
+				length += distance(order[i], order[(i + 1) % n]);
+			if (length >= INF) continue;
+
+			std::vector<std::pair<double, double>> ignored;
+			auto search = [&](auto &tour) {
+				LinKernighan<std::decay_t<decltype(tour)>, decltype(dist)> lk(tour, dist, candidates, k, length, control);
+				lk.improved = [&]() {
+					control.report(lk.length, [&]() {
+						std::vector<int> closed = tour.vertexes(std::max(0, current.csr.findIndex(0)));
+						closed.push_back(closed.front());
+						return tourOf(closed, control.elapsed());
+					});
+				};
+				lk.iterate(start, deadline, deadline, (size_t)n * MULTI_START_KICKS_PER_VERTEX, random(), ignored);
+				length = lk.length;
+				order = tour.vertexes(order.front());
+			};
+			if (n >= TWO_LEVEL_TOUR_MIN_VERTEXES)
+			{
+				TwoLevelTour tour(order);
+				search(tour);
+			}
+			else
+			{
+				ArrayTour tour(order);
+				search(tour);
+			}
+			starts++;
+
+			std::lock_guard<std::mutex> lock(bestMutex);
+			if (length < best)
+			{
+				best = length;
+				bestOrder = order;
+				convergence.push_back({elapsed(), best});
+			}
+		} while (std::chrono::high_resolution_clock::now() < deadline && !control.check());
+		startsPerSecond[worker] = starts / std::chrono::duration<double>(
+			std::chrono::high_resolution_clock::now() - workerStart).count();
+	}, threads, 1);
+	if (bestOrder.empty()) return {-2, {}, {}, -2};
+
+	// Same start as the other heuristics, the vertex with id 0 if there is one
+	int first = std::max(0, current.csr.findIndex(0));
+	std::rotate(bestOrder.begin(), std::find(bestOrder.begin(), bestOrder.end(), first), bestOrder.end());
+	bestOrder.push_back(bestOrder.front());
+
+	auto end = std::chrono::high_resolution_clock::now();
+	ReturnDataTSP result = tourOf(bestOrder, std::chrono::duration<double>(end - start).count());
+	result.convergence = convergence;
+	result.startsPerSecond = startsPerSecond;
+	result.interrupted = control.isStopped();
+	return result;
+}
+
+/**
+ * Multi-start Lin-Kernighan for 2 seconds, on the threads selected with setMultiStartThreads.
+ * @param control Deadline, cancellation and callback of the run.
+ * @return Structure with the time taken, stops, distances between stops and total distance travelled.
+ * @note Complexity: O(V^2) for the candidates, then the local searches split between the threads
+*/
+ReturnDataTSP Manager::multiStartHeuristic(SolveControl &control) const
+{
+	return multiStartLinKernighan(multiStartThreads, LK_TIME_LIMIT, control);
+}
+
+/**
+ * Selects the number of threads of the multi-start solver.
+ * @param threads Number of threads, 0 meaning one per hardware thread.
+*/
+void Manager::setMultiStartThreads(unsigned threads)
+{
+	multiStartThreads = threads;
+}
+
+/**
+ * @return Number of threads of the multi-start solver, 0 meaning one per hardware thread.
+*/
+unsigned Manager::getMultiStartThreads() const
+{
+	return multiStartThreads;
+}
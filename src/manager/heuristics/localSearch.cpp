@@ -0,0 +1,345 @@
+#include "../manager.h"
+#include <deque>
+#include <numeric>
+
+/** Candidate neighbours per vertex tried by the moves. */
+#define LOCAL_SEARCH_NEIGHBOURS 10
+
+/** Longest segment moved by Or-opt. */
+#define OR_OPT_MAX_SEGMENT 3
+
+/** Improvements smaller than this fraction of the edges removed are ignored, as rounding noise. */
+#define LOCAL_SEARCH_EPSILON 1e-9
+
+/**
+ * Nearest vertexes of every vertex by the distances of the graph, from full rows.
+ * Missing edges are never candidates, so a vertex may have fewer than k, the rest being -1.
+ * @return Flat list where the candidates of vertex v are at [v * k, (v + 1) * k), closest first.
+ * @note Complexity: O(V^2)
+*/
+static std::vector<int> nearestByRows(const Manager &manager, int n, int k)
+{
+	std::vector<int> lists((size_t)n * k, -1);
+	parallelFor(0, n, [&](size_t v, unsigned) {
+		std::vector<double> row;
+		manager.distanceRow(v, row);
+		row[v] = INF;
+		std::vector<int> order(n);
+		std::iota(order.begin(), order.end(), 0);
+		std::partial_sort(order.begin(), order.begin() + k, order.end(),
+			[&](int a, int b) { return row[a] < row[b] || (row[a] == row[b] && a < b); });
+		for (int i = 0; i < k && row[order[i]] != INF; i++)
+			lists[v * k + i] = order[i];
+	}, 0, 16);
+	return lists;
+}
+
+/**
+ * State of the local search on a tour stored as an array of vertexes
+ * and the position of each vertex in it.
+ * Vertexes whose neighbourhood changed are queued, the others are not looked at
+ * again until a move touches them (don't-look bits).
+*/
+template <typename Distance>
+struct TourImprover {
+	Distance distance;
+	int n;
+	bool symmetric;
+	const std::vector<int> &candidates;
+	int k;
+
+	std::vector<int> order;
+	std::vector<int> position;
+	std::vector<bool> queued;
+	std::deque<int> queue;
+	size_t moves = 0;
+
+	TourImprover(Distance distance, const std::vector<int> &tour, bool symmetric,
+		const std::vector<int> &candidates, int k)
+		: distance(distance), n(tour.size()), symmetric(symmetric), candidates(candidates), k(k),
+		order(tour), position(n), queued(n, false)
+	{
+		for (int i = 0; i < n; i++)
+		{
+			position[order[i]] = i;
+			activate(order[i]);
+		}
+	}
+
+	int next(int v) const { return order[position[v] + 1 == n ? 0 : position[v] + 1]; }
+	int prev(int v) const { return order[position[v] == 0 ? n - 1 : position[v] - 1]; }
+
+	void activate(int v)
+	{
+		if (queued[v]) return;
+		queued[v] = true;
+		queue.push_back(v);
+	}
+
+	bool improves(double delta, double removed) const
+	{
+		return delta < -LOCAL_SEARCH_EPSILON * removed;
+	}
+
+	void reverse(int from, int to);
+	void moveSegment(int first, int length, int at, bool after, bool reversed);
+	bool twoOpt(int a);
+	bool orOpt(int a);
+};
+
+/**
+ * Reverses the path going forward from one vertex to another.
+ * On symmetric distances, reversing the rest of the tour instead gives the same tour
+ * backwards, so the shorter of both is reversed.
+ * @note Complexity: O(V)
+*/
+template <typename Distance>
+void TourImprover<Distance>::reverse(int from, int to)
+{
+	int i = position[from], j = position[to];
+	int length = (j - i + n) % n + 1;
+	if (2 * length > n)
+	{
+		std::swap(i, j);
+		i = (i + 1) % n;
+		j = (j + n - 1) % n;
+		length = n - length;
+	}
+	for (int s = 0; s < length / 2; s++)
+	{
+		int a = (i + s) % n, b = (j - s + n) % n;
+		std::swap(order[a], order[b]);
+		position[order[a]] = a;
+		position[order[b]] = b;
+	}
+}
+
+/**
+ * Moves a segment of the tour next to another vertex.
+ * Only the vertexes between the segment and its new place are shifted, on whichever
+ * side of the tour is shorter, which gives the same tour up to a rotation of the array.
+ * @param first First vertex of the segment, going forward.
+ * @param length Number of vertexes of the segment, at most OR_OPT_MAX_SEGMENT.
+ * @param at Vertex out of the segment to move it next to.
+ * @param after If true, the segment goes right after at, otherwise right before it.
+ * @param reversed If true, the segment is also reversed.
+ * @note Complexity: O(length + the shorter distance between the segment and at)
+*/
+template <typename Distance>
+void TourImprover<Distance>::moveSegment(int first, int length, int at, bool after, bool reversed)
+{
+	int start = position[first];
+	int gap = (position[at] + (after ? 1 : 0)) % n;
+	int segment[OR_OPT_MAX_SEGMENT];
+	for (int i = 0; i < length; i++)
+		segment[reversed ? length - 1 - i : i] = order[(start + i) % n];
+	auto place = [&](int i, int v) {
+		order[i] = v;
+		position[v] = i;
+	};
+
+	// Vertexes from the end of the segment to the gap, and from the gap to the segment
+	int ahead = (gap - start - length + 2 * n) % n;
+	int behind = (start - gap + n) % n;
+	if (ahead <= behind)
+	{
+		for (int i = 0; i < ahead; i++)
+			place((start + i) % n, order[(start + length + i) % n]);
+		for (int i = 0; i < length; i++)
+			place((start + ahead + i) % n, segment[i]);
+	}
+	else
+	{
+		for (int i = behind - 1; i >= 0; i--)
+			place((gap + length + i) % n, order[(gap + i) % n]);
+		for (int i = 0; i < length; i++)
+			place((gap + i) % n, segment[i]);
+	}
+}
+
+/**
+ * Tries the 2-opt moves removing an edge of a vertex: the edge is replaced by one to a
+ * candidate neighbour c, and the edge of c on the same side by the edge between the other ends.
+ * Candidates are closest first, so the search stops at the first one farther than the removed edge.
+ * Needs symmetric distances, as the path between both edges is reversed.
+ * @return True if an improving move was applied.
+*/
+template <typename Distance>
+bool TourImprover<Distance>::twoOpt(int a)
+{
+	for (int side = 0; side < 2; side++)
+	{
+		int b = side == 0 ? next(a) : prev(a);
+		double removed = distance(a, b);
+		for (int i = 0; i < k; i++)
+		{
+			int c = candidates[(size_t)a * k + i];
+			if (c == -1) break;
+			double added = distance(a, c);
+			if (added >= removed) break;
+			int d = side == 0 ? next(c) : prev(c);
+			if (c == b || d == a) continue;
+
+			double delta = added + distance(b, d) - removed - distance(c, d);
+			if (!improves(delta, removed + distance(c, d))) continue;
+			if (side == 0) reverse(b, c);
+			else reverse(c, b);
+			activate(a), activate(b), activate(c), activate(d);
+			moves++;
+			return true;
+		}
+	}
+	return false;
+}
+
+/**
+ * Tries the Or-opt moves of the segments of 1 to 3 vertexes starting at a vertex:
+ * the segment is taken out and put back between a candidate neighbour of one of its ends
+ * and the vertex before or after it, reversed if that is shorter.
+ * Moves that reverse the segment are only tried on symmetric distances.
+ * @return True if an improving move was applied.
+*/
+template <typename Distance>
+bool TourImprover<Distance>::orOpt(int a)
+{
+	for (int length = 1; length <= OR_OPT_MAX_SEGMENT && length + 3 <= n; length++)
+	{
+		int first = a, last = order[(position[a] + length - 1) % n];
+		int before = prev(first), after = next(last);
+		double removed = distance(before, first) + distance(last, after);
+		double gain = removed - distance(before, after);
+		if (gain <= 0) continue;
+		auto inSegment = [&](int v) { return (position[v] - position[first] + n) % n < length; };
+
+		for (int end = 0; end < 2; end++)
+		{
+			int owner = end == 0 ? first : last;
+			for (int i = 0; i < k; i++)
+			{
+				int c = candidates[(size_t)owner * k + i];
+				if (c == -1) break;
+				if (inSegment(c)) continue;
+
+				// The owner end goes next to c, on either side of it
+				for (int side = 0; side < 2; side++)
+				{
+					bool placeAfter = side == 0;
+					int other = placeAfter ? next(c) : prev(c);
+					if (inSegment(other)) continue;
+					int from = placeAfter ? c : other, to = placeAfter ? other : c;
+					bool reversed = (end == 0) != placeAfter;
+					if (reversed && !symmetric) continue;
+					if (from == before && to == after) continue;
+
+					int head = reversed ? last : first, tail = reversed ? first : last;
+					double added = distance(from, head) + distance(tail, to) - distance(from, to);
+					double delta = added - gain;
+					if (!improves(delta, removed + distance(from, to))) continue;
+
+					moveSegment(first, length, c, placeAfter, reversed);
+					activate(before), activate(after), activate(first), activate(last);
+					activate(from), activate(to);
+					moves++;
+					return true;
+				}
+			}
+		}
+	}
+	return false;
+}
+
+/**
+ * @return True if every edge of the network has the same weight both ways.
+ * @note Complexity: O(E log V)
+*/
+bool Manager::hasSymmetricDistances() const
+{
+	for (int u = 0; u < current.csr.getNumVertex(); u++)
+		for (size_t e = current.csr.edgeBegin(u); e < current.csr.edgeEnd(u); e++)
+			if (distance(current.csr.getDest(e), u) != current.csr.getWeight(e)) return false;
+	return true;
+}
+
+/**
+ * Improves a tour with 2-opt and Or-opt moves until none improves it
+ * or the budget runs out, applying the first improving move found.
+ * Moves only connect vertexes to their nearest neighbours, taken from the spatial index on
+ * implicitly completed graphs and from the rows of distances otherwise.
+ * Each vertex is looked at again only when a move changed one of its edges (don't-look bits).
+ * 2-opt needs symmetric distances, so on directed graphs only segments are moved, forwards.
+ * @param tour Tour returned by a heuristic, starting and ending at the same vertex.
+ * @param timeLimit Maximum time to spend, in seconds.
+ * @param maxMoves Maximum number of moves to apply.
+ * @return The improved tour, with the same start. The length before, the number of moves
+ * and the time taken are also returned. Tours that do not visit every vertex once
+ * or use a missing edge are returned unchanged.
+ * @note Complexity: O(V^2) for the neighbour lists, then O(V) per move
+*/
+ReturnDataTSP Manager::improveTour(const ReturnDataTSP &tour, double timeLimit, size_t maxMoves) const
+{
+	auto start = std::chrono::high_resolution_clock::now();
+	ReturnDataTSP result = tour;
+	int n = current.csr.getNumVertex();
+	if (n < 5 || tour.stops.size() != (size_t)n + 1 || tour.stops.front() != tour.stops.back()) return result;
+
+	std::vector<int> order;
+	std::vector<bool> seen(n, false);
+	double initial = 0;
+	for (int i = 0; i < n; i++)
+	{
+		int v = current.csr.findIndex(tour.stops[i]);
+		if (v == -1 || seen[v]) return result;
+		seen[v] = true;
+		order.push_back(v);
+		if (i > 0) initial += distance(order[i - 1], v);
+	}
+	initial += distance(order.back(), order.front());
+	if (initial >= INF) return result;
+
+	int k = std::min(LOCAL_SEARCH_NEIGHBOURS, n - 1);
+	std::vector<int> candidates = current.implicitlyCompleted && current.kdtree.size() == n
+		? candidateLists(k) : nearestByRows(*this, n, k);
+	auto dist = [this](int u, int v) { return distance(u, v); };
+	TourImprover<decltype(dist)> search(dist, order, hasSymmetricDistances(), candidates, k);
+
+	// Moves also change the segments starting at the vertexes they do not touch,
+	// so all of them are looked at again until a whole pass finds nothing
+	auto deadline = start + std::chrono::duration<double>(timeLimit);
+	size_t sweepMoves = 0;
+	for (size_t steps = 0; search.moves < maxMoves; steps++)
+	{
+		if (steps % 256 == 0 && std::chrono::high_resolution_clock::now() > deadline) break;
+		if (search.queue.empty())
+		{
+			if (search.moves == sweepMoves) break;
+			sweepMoves = search.moves;
+			for (int v : search.order)
+				search.activate(v);
+		}
+		int a = search.queue.front();
+		search.queue.pop_front();
+		search.queued[a] = false;
+		if ((search.symmetric && search.twoOpt(a)) || search.orOpt(a)) search.activate(a);
+	}
+
+	// Same start as the original tour
+	order = search.order;
+	std::rotate(order.begin(), order.begin() + search.position[current.csr.findIndex(tour.stops.front())], order.end());
+	order.push_back(order.front());
+	result.stops.clear();
+	result.distances.clear();
+	result.totalDistance = 0;
+	for (size_t i = 0; i < order.size(); i++)
+	{
+		result.stops.push_back(current.csr.getId(order[i]));
+		if (i == 0) continue;
+		result.distances.push_back(distance(order[i - 1], order[i]));
+		result.totalDistance += result.distances.back();
+	}
+
+	auto end = std::chrono::high_resolution_clock::now();
+	result.initialDistance = initial;
+	result.improvingMoves = search.moves;
+	result.improvementTime = std::chrono::duration<double>(end - start).count();
+	return result;
+}
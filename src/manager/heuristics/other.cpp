@@ -1,30 +1,26 @@
 #include "../manager.h"
 
 /**
- * Divides the initial graph into clusters 
- * where each node is at maximum (distance) km of a central node.
- * @param g Base graph.
- * @param distance Maximum distance between nodes in a cluster.
- * @param clusters Vector to put the clusters.
- * @note Complexity: O(V + C) where C is the number of clusters.
+ * Divides the initial graph into clusters
+ * where each node is at maximum (maxDistance) km of a central node.
+ * @param maxDistance Maximum distance between nodes in a cluster.
+ * @param clusters Vector to put the clusters, as vertex indexes.
+ * @note Complexity: O(V * C) where C is the number of clusters.
 */
-void Manager::createClusters(Graph& g, double distance,
-    std::vector<std::vector<Vertex*>>& clusters)
+void Manager::createClusters(double maxDistance, std::vector<std::vector<int>>& clusters) const
 {
-    Vertex* v = g.findVertex(0);
+    int first = current.csr.findIndex(0);
 
-    clusters.push_back({v});
+    clusters.push_back({first});
 
-    std::vector<Vertex*> nodes = g.getVertexSet();
-
-    for (auto& vertex : nodes)
+    for (int vertex = 0; vertex < current.csr.getNumVertex(); vertex++)
 	{
         bool fitted = false;
-        if (vertex->getId() == 0) continue;
+        if (vertex == first) continue;
 
         for (auto& cluster : clusters)
 		{
-            if (vertex->getEdgeTo(cluster.front())->getWeight() <= distance)
+            if (distance(vertex, cluster.front()) <= maxDistance)
 			{
                 cluster.push_back(vertex);
                 fitted = true;
@@ -38,66 +34,67 @@ void Manager::createClusters(Graph& g, double distance,
 /**
  * Runs the triangular approximation algorithm for each cluster.
  * @param graph Cluster graph.
- * @param vertex Base vertex.
+ * @param base Index of the base vertex.
  * @param stops Vector where the stops are saved.
  * @param distances Vector with the distances between stops.
  * @return Total distance travelled inside the cluster.
- * @note Complexity: O(V + E)
+ * @note Complexity: O(E log V)
 */
-double Manager::triangularCluster(Graph& graph, Vertex* base,
-    std::vector<int>& stops, std::vector<double>& distances)
+double Manager::triangularCluster(const CSRGraph& graph, int base,
+    std::vector<int>& stops, std::vector<double>& distances) const
 {
     double totalDistance = 0;
-    Graph mst = PrimMST(graph, base);
+    std::vector<int> order = PrimMST(graph, base).preorder(base);
 
-    for (Vertex* vtx : graph.getVertexSet()) vtx->setVisited(false);
-
-    Vertex* mstBase = mst.findVertex(base->getId());
-    trianApproxDfs(mstBase, nullptr, stops, distances, &totalDistance);
+    stops.push_back(graph.getId(order.front()));
+    for (size_t i = 1; i < order.size(); i++)
+	{
+        double dist = graph.getWeight(order[i - 1], order[i]);
+        if (dist == INF) dist = 0;
+        stops.push_back(graph.getId(order[i]));
+        distances.push_back(dist);
+        totalDistance += dist;
+    }
     return totalDistance;
 }
 
 /**
- * This heuristic uses triangular approximation, 
+ * This heuristic uses triangular approximation,
  * but first divides the network into smaller closer clusters. (Divide&Conqueer)
+ * Clusters are connected by the distance from each cluster's anchor
+ * to the last stop of every other cluster.
  * @return Structure with the time taken, stops, distances between stops and max distance travelled.
- * @note Complexity: O(E log V)
+ * @note Complexity: O(V^2)
 */
-ReturnDataTSP Manager::otherHeuristic()
+ReturnDataTSP Manager::otherHeuristic() const
 {
     // Calculate which distance to use
     double totalWeight = 0;
-    size_t numberVertex = network.getVertexSet().size();
-    int count = 0;
+    int numberVertex = current.csr.getNumVertex();
+    long count = 0;
 
-    auto testStart = std::chrono::high_resolution_clock::now();
-    auto vertexSet = network.getVertexSet();
+    if (current.csr.findIndex(0) == -1) return {-1, {}, {}, -1};
 
     // Calculate average distance
-    for (size_t i = 0; i < numberVertex - 1; i++)
+    std::vector<double> row;
+    for (int i = 0; i < numberVertex - 1; i++)
 	{
-        for (size_t j = i + 1; j < numberVertex; j++)
+        distanceRow(i, row);
+        for (int j = i + 1; j < numberVertex; j++)
 		{
+            if (row[j] == INF) continue;
             count++;
-            Edge* edge = vertexSet[i]->getEdgeTo(vertexSet[j]);
-            totalWeight += edge->getWeight();
+            totalWeight += row[j];
         }
     }
 
-    auto testEnd = std::chrono::high_resolution_clock::now();
-    auto testFinal = std::chrono::duration<double>(testEnd - testStart).count();
-    std::cout << testFinal;
-    double distance = totalWeight / (count) * 0.2;
+    double maxDistance = totalWeight / (count) * 0.2;
 
     auto start = std::chrono::high_resolution_clock::now();
 
-    testStart = std::chrono::high_resolution_clock::now();
     // Create the clusters
-    std::vector<std::vector<Vertex*>> clusters;
-    createClusters(network, distance, clusters);
-
-    testEnd = std::chrono::high_resolution_clock::now();
-    testFinal = std::chrono::duration<double>(testEnd - testStart).count();
+    std::vector<std::vector<int>> clusters;
+    createClusters(maxDistance, clusters);
 
     double totalDistance = 0;
 
@@ -106,87 +103,80 @@ ReturnDataTSP Manager::otherHeuristic()
     std::unordered_map<int, std::vector<double>> clusterDistances;
     std::unordered_map<int, std::vector<int>> clusterStops;
 
-    testStart = std::chrono::high_resolution_clock::now();
     // Calculate connections inside clusters
     for (auto& cluster : clusters)
 	{
-        Graph clusterGraph;
+        std::vector<int> ids;
+        std::vector<CSREdge> edges;
         std::vector<int> stops;
         std::vector<double> distances;
 
         // Populate the graph
-        for (Vertex* & v : cluster)
+        for (int v : cluster)
 		{
-            clusterGraph.addVertex(v->getId(), v->getInfo());
+            ids.push_back(current.csr.getId(v));
         }
 
-        for (auto it = cluster.begin(); std::next(it) != cluster.end(); ++it)
+        for (size_t i = 0; i + 1 < cluster.size(); i++)
 		{
-            for (auto jt = std::next(it); jt != cluster.end(); ++jt)
+            for (size_t j = i + 1; j < cluster.size(); j++)
 			{
-                Edge* e = (*it)->getEdgeTo(*jt);
-                clusterGraph.addBidirectionalEdge(
-                    (*it)->getId(), (*jt)->getId(), e->getWeight());
+                double weight = distance(cluster[i], cluster[j]);
+                if (weight == INF) continue;
+                edges.push_back({(int)i, (int)j, weight});
             }
         }
 
         // Perform the algorithm
         totalDistance += triangularCluster(
-            clusterGraph, 
-			clusterGraph.findVertex(cluster.front()->getId()),
+            CSRGraph(ids, edges, true),
+			0,
             stops,
 			distances
 		);
 
-        clusterDistances[cluster.front()->getId()] = distances;
-        clusterStops[cluster.front()->getId()] = stops;
+        clusterDistances[current.csr.getId(cluster.front())] = distances;
+        clusterStops[current.csr.getId(cluster.front())] = stops;
     }
 
-    testEnd = std::chrono::high_resolution_clock::now();
-    testFinal = std::chrono::duration<double>(testEnd - testStart).count();
     // Connect cluster with respect to start and end of MST
-    Graph anchorGraph;
+    std::vector<int> anchorIds;
+    std::vector<CSREdge> anchorEdges;
 
-    testStart = std::chrono::high_resolution_clock::now();
     // Populate the graph
-    for (auto cluster : clusters)
+    for (auto& cluster : clusters)
 	{
-        anchorGraph.addVertex(cluster.front()->getId(), cluster.front()->getInfo());
+        anchorIds.push_back(current.csr.getId(cluster.front()));
     }
 
-    for (auto originCluster : clusters)
+    for (size_t i = 0; i < clusters.size(); i++)
 	{
-        Vertex* origin = originCluster.front();
-        for (auto endCluster : clusters)
+        int origin = clusters[i].front();
+        for (size_t j = 0; j < clusters.size(); j++)
 		{
-            if (originCluster == endCluster) continue;
-            int end = clusterStops[endCluster.front()->getId()].back();
-            anchorGraph.addEdge(
-                origin->getId(), end,
-                origin->getEdgeTo(network.findVertex(end))->getWeight());
+            if (i == j) continue;
+            int end = current.csr.findIndex(clusterStops[anchorIds[j]].back());
+            double weight = distance(origin, end);
+            if (weight == INF) continue;
+            anchorEdges.push_back({(int)i, (int)j, weight});
         }
     }
+    CSRGraph anchorGraph(anchorIds, anchorEdges, false);
 
-    testEnd = std::chrono::high_resolution_clock::now();
-    testFinal = std::chrono::duration<double>(testEnd - testStart).count();
     // Perform Triangular Aproximation to connect the clusters
     std::vector<double> connectingDistances;
     std::vector<int> connectingStops;
 
-    testStart = std::chrono::high_resolution_clock::now();
     totalDistance += triangularCluster(
-		anchorGraph, 
-		anchorGraph.findVertex(0),
+		anchorGraph,
+		anchorGraph.findIndex(0),
         connectingStops,
 		connectingDistances
 	);
 
-    testEnd = std::chrono::high_resolution_clock::now();
-    testFinal = std::chrono::duration<double>(testEnd - testStart).count();
     std::vector<int> finalStops;
     std::vector<double> finalDistances;
 
-    testStart = std::chrono::high_resolution_clock::now();
     // Iterate through the result to join paths
     auto jt = connectingDistances.begin();
     for (auto it = connectingStops.begin(); it != connectingStops.end(); it++)
@@ -205,14 +195,12 @@ ReturnDataTSP Manager::otherHeuristic()
 
     finalStops.push_back(connectingStops.front());
     int finalCluster = connectingStops.back();
-    Vertex* finalVertex = network.findVertex(clusterStops[finalCluster].back());
-    Edge* finalEdge = network.findVertex(0)->getEdgeTo(finalVertex);
-    double finalWeight = finalEdge != nullptr ? finalEdge->getWeight() : 0;
+    int finalVertex = current.csr.findIndex(clusterStops[finalCluster].back());
+    double finalWeight = distance(current.csr.findIndex(0), finalVertex);
+    if (finalWeight == INF) finalWeight = 0;
     finalDistances.push_back(finalWeight);
     totalDistance += finalWeight;
 
-    testEnd = std::chrono::high_resolution_clock::now();
-    testFinal = std::chrono::duration<double>(testEnd - testStart).count();
     auto end = std::chrono::high_resolution_clock::now();
     return {std::chrono::duration<double>(end - start).count(), finalStops, finalDistances, totalDistance};
 }
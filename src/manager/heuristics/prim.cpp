@@ -0,0 +1,153 @@
+#include "../manager.h"
+#include "../../graph/indexedHeap.h"
+
+/** Children per node of the heap used on sparse graphs. */
+#define PRIM_HEAP_ARITY 4
+
+/**
+ * Prim's algorithm with an array of keys (O(V^2)), for dense graphs.
+ * Each step scans the keys for the closest vertex to the tree, which is the lowest index
+ * among the closest ones, and lowers the keys of the others with its row of distances.
+ * Both scans are branch-free loops over the arrays, so they are vectorized.
+ * Vertexes already in the tree have a negative key, so no distance is below it.
+ * @param n Number of vertexes.
+ * @param base Index of the starting vertex.
+ * @param rows Fills a vector with the distances from a vertex to every other, INF without an edge.
+ * @return Parent of each vertex in the tree.
+ * @note Complexity: O(V^2) plus the rows
+*/
+template <typename Rows>
+SpanningTree Manager::PrimDense(int n, int base, Rows rows) const
+{
+	SpanningTree tree(n, INF);
+	std::vector<double> key(n, INF);
+	std::vector<double> row;
+	const double *keys = key.data();
+
+	key[base] = 0;
+	for (int i = 0; i < n; i++)
+	{
+		double closest = INF;
+		for (int v = 0; v < n; v++)
+			closest = std::min(closest, keys[v] < 0 ? INF : keys[v]);
+		if (closest == INF) break;
+		int u = std::find(key.begin(), key.end(), closest) - key.begin();
+		tree.weight[u] = closest;
+		key[u] = -1;
+
+		rows(u, row);
+		const double *distances = row.data();
+		double *lowered = key.data();
+		int *parent = tree.parent.data();
+		for (int v = 0; v < n; v++)
+		{
+			bool closer = distances[v] < lowered[v];
+			lowered[v] = closer ? distances[v] : lowered[v];
+			parent[v] = closer ? u : parent[v];
+		}
+	}
+	tree.weight[base] = 0;
+	return tree;
+}
+
+/**
+ * Prim's algorithm with an indexed D-ary heap (O(E log V)), for sparse graphs.
+ * Every vertex is in the heap at most once, and its key is lowered in place.
+ * Ties are broken by the lowest index, like the dense version, so both build the same tree.
+ * @param g Base graph to operate on.
+ * @param base Index of the starting vertex.
+ * @return Parent of each vertex in the tree.
+ * @note Complexity: O(E log V)
+*/
+SpanningTree Manager::PrimHeap(const CSRGraph &g, int base) const
+{
+	int n = g.getNumVertex();
+	SpanningTree tree(n, INF);
+	std::vector<bool> visited(n, false);
+	IndexedHeap<PRIM_HEAP_ARITY> queue(n);
+
+	queue.push(base, 0);
+	while (!queue.empty())
+	{
+		int u = queue.pop();
+		visited[u] = true;
+		tree.weight[u] = queue.key(u);
+
+		for (size_t e = g.edgeBegin(u); e < g.edgeEnd(u); e++)
+		{
+			int v = g.getDest(e);
+			if (visited[v] || (queue.contains(v) && g.getWeight(e) >= queue.key(v))) continue;
+			tree.parent[v] = u;
+			queue.push(v, g.getWeight(e));
+		}
+	}
+	tree.weight[base] = 0;
+	return tree;
+}
+
+/**
+ * Builds a minimum spanning tree of a graph with the engine suited to it.
+ * @param g Base graph to operate on.
+ * @param base Index of the starting vertex.
+ * @param dense If true, uses the array version with rows built from the edges of the graph,
+ * otherwise the heap version.
+ * @return Parent of each vertex in the tree.
+ * @note Complexity: O(V^2) if dense, O(E log V) otherwise
+*/
+SpanningTree Manager::PrimParents(const CSRGraph &g, int base, bool dense) const
+{
+	if (!dense) return PrimHeap(g, base);
+
+	int n = g.getNumVertex();
+	return PrimDense(n, base, [&](int u, std::vector<double> &row) {
+		row.assign(n, INF);
+		for (size_t e = g.edgeEnd(u); e-- > g.edgeBegin(u);)
+			row[g.getDest(e)] = std::min(row[g.getDest(e)], g.getWeight(e));
+	});
+}
+
+/**
+ * Builds a minimum spanning tree of the complete graph given by Manager::distance,
+ * with the array version of Prim's algorithm.
+ * Distances are computed a row at a time with Manager::distanceRow.
+ * Used when the network is implicitly completed, as its edges are not stored.
+ * @param base Index of the starting vertex.
+ * @return Parent of each vertex in the tree.
+ * @note Complexity: O(V^2)
+*/
+SpanningTree Manager::PrimParentsComplete(int base) const
+{
+	return PrimDense(current.csr.getNumVertex(), base, [&](int u, std::vector<double> &row) {
+		distanceRow(u, row);
+	});
+}
+
+/**
+ * Creates a minimum span tree using Prim's Algorithm.
+ * Graphs with at least a quarter of all possible edges use the array version,
+ * which does not pay for a heap, and sparser ones the heap version.
+ * @note Complexity: O(V^2) on dense graphs, O(E log V) otherwise
+ * @param g Base graph to operate on.
+ * @param base Index of the starting vertex.
+ * @return Tree over the vertex indexes of the base graph, with its children linked.
+*/
+SpanningTree Manager::PrimMST(const CSRGraph &g, int base) const
+{
+	size_t n = g.getNumVertex();
+	SpanningTree tree = PrimParents(g, base, g.getNumEdges() * 4 >= n * n);
+	tree.linkChildren();
+	return tree;
+}
+
+/**
+ * Creates a minimum span tree of the complete graph given by Manager::distance.
+ * @note Complexity: O(V^2)
+ * @param base Index of the starting vertex.
+ * @return Tree over the vertex indexes of the network, with its children linked.
+*/
+SpanningTree Manager::PrimMSTComplete(int base) const
+{
+	SpanningTree tree = PrimParentsComplete(base);
+	tree.linkChildren();
+	return tree;
+}
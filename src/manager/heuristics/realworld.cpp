@@ -1,45 +1,42 @@
 #include "../manager.h"
-#include "../../ui/ui.h"
 
 /**
  * Finds the "perfect match" edge for each vertex.
  * A "perfect match" is an edge where the distance 
  * between the base vertex and another vertex is the minimal.
  * That is the best path option only considering that vertex.
- * @param mst Minimum-span tree graph.
+ * @param mst Minimum-span tree, whose neighbours are read from its parent and child arrays.
  * @return Vector of edges that are "perfect matches".
- * @note Complexity: O(V + E)
+ * @note Complexity: O(V)
 */
-std::vector<Edge *> Manager::perfectMatching(Graph &mst)
+std::vector<CSREdge> Manager::perfectMatching(const SpanningTree &mst) const
 {
-	std::vector<Edge *> matches;
-	std::vector<Vertex *> oddVertexes;
-	
-	for (auto vtx : mst.getVertexSet())
-	{
-		vtx->setVisited(false);
-		if (vtx->getAdj().size() % 2) oddVertexes.push_back(vtx);
-	}
+	std::vector<CSREdge> matches;
+	int n = mst.parent.size();
+	std::vector<bool> visited(n, false);
 
-	for (auto vtx : mst.getVertexSet())
+	for (int vtx = 0; vtx < n; vtx++)
 	{
-		if (vtx->isVisited()) continue;
+		if (visited[vtx]) continue;
 
-		Edge *match = nullptr;
+		int match = -1;
+		double matchWeight = INF;
 
-		for (auto e : vtx->getAdj())
-		{
-			Vertex *u = e->getDest();
-			if (u->isVisited()) continue;
+		mst.forEachNeighbour(vtx, [&](int u, double weight) {
+			if (visited[u]) return;
 			
-			if (match == nullptr || e->getWeight() < match->getWeight()) match = e;
-		}
-
-		if (match != nullptr)
+			if (match == -1 || weight < matchWeight)
+			{
+				match = u;
+				matchWeight = weight;
+			}
+		});
+
+		if (match != -1)
 		{
-			matches.push_back(match);
-			vtx->setVisited(true);
-			match->getDest()->setVisited(true);
+			matches.push_back({vtx, match, matchWeight});
+			visited[vtx] = true;
+			visited[match] = true;
 		}
 	}
 
@@ -49,29 +46,32 @@ std::vector<Edge *> Manager::perfectMatching(Graph &mst)
 /**
  * Returns an Euler Path, which is a trail that visits every edge exacly once.
  * Vertexes can be re-visited.
- * @param base Base Vertex where the path/walk will start.
- * @return Vector containing the Euler Path/Walk.
- * @note Complexity: O(V)
+ * The graph is not modified, expanded vertexes are tracked separately.
+ * @param g Graph to go through.
+ * @param base Index of the base Vertex where the path/walk will start.
+ * @return Vector containing the indexes of the Euler Path/Walk.
+ * @note Complexity: O(V + E)
 */
-std::vector<Vertex *> Manager::eulerPath(Vertex *base)
+std::vector<int> Manager::eulerPath(const CSRGraph &g, int base) const
 {
-	std::vector<Vertex *> stops;
-	std::stack<Vertex *> stk;
+	std::vector<int> stops;
+	std::vector<bool> expanded(g.getNumVertex(), false);
+	std::stack<int> stk;
 	stk.push(base);
 
 	while (!stk.empty())
 	{
-		Vertex *u = stk.top();
-		if (u->getAdj().size() == 0)
+		int u = stk.top();
+		if (expanded[u] || g.getDegree(u) == 0)
 		{
 			stops.push_back(u);
 			stk.pop();
 			continue;
 		}
 		
-		for (auto edg : u->getAdj())
-			stk.push(edg->getDest());
-		u->clearAdj();
+		for (size_t e = g.edgeBegin(u); e < g.edgeEnd(u); e++)
+			stk.push(g.getDest(e));
+		expanded[u] = true;
 	}
 
 	return stops;
@@ -80,21 +80,22 @@ std::vector<Vertex *> Manager::eulerPath(Vertex *base)
 /**
  * Generates an Hamilton Circuit from a Euler Path.
  * Goes through the Euler Path and removed non-unique vertexes from it.
- * @param eulerStops Euler Path/Walk.
- * @return Vector with the stops of the Hamilton Circuit.
+ * @param g Graph the Euler Path was generated from.
+ * @param eulerStops Euler Path/Walk, by vertex index.
+ * @return Vector with the ids of the stops of the Hamilton Circuit.
  * @note Complexity: O(V)
 */
-std::vector<int> Manager::hamilton(std::vector<Vertex *> &eulerStops)
+std::vector<int> Manager::hamilton(const CSRGraph &g, std::vector<int> &eulerStops) const
 {
-	std::unordered_set<Vertex *> vertexes;
+	std::vector<bool> vertexes(g.getNumVertex(), false);
 	std::vector<int> stops;
 
 	for (auto vtx : eulerStops)
 	{
-		if (vertexes.find(vtx) == vertexes.end())
+		if (!vertexes[vtx])
 		{
-			vertexes.insert(vtx);
-			stops.push_back(vtx->getId());
+			vertexes[vtx] = true;
+			stops.push_back(g.getId(vtx));
 		}
 	}
 
@@ -106,22 +107,19 @@ std::vector<int> Manager::hamilton(std::vector<Vertex *> &eulerStops)
  * It goes through every pair of sequential nodes and checks if there is a edge between both in the graph.
  * The distance between stops is also calculated during this verification.
  * @note Complexity: O(V)
- * @param g Network graph
  * @param stops Vector containing the stops of the path.
  * @param dists Vector where the distance between stops is saved.
  * @param totalDist Pointer to double where the total distanced travelled is saved.
  * @return If the path is invalid.
 */
-bool Manager::invalidPath(Graph &g, std::vector<int> &stops, std::vector<double> &dists, double *totalDist)
+bool Manager::invalidPath(std::vector<int> &stops, std::vector<double> &dists, double *totalDist) const
 {
 	for (size_t i = 0; i < stops.size() - 1; i++)
 	{
-		Vertex *u = g.findVertex(stops[i]);
-		Vertex *v = g.findVertex(stops[i + 1]);
-		Edge *edg = u->getEdgeTo(v);
-		if (edg == nullptr) return true;
-		dists.push_back(edg->getWeight());
-		*totalDist += edg->getWeight();
+		double weight = distance(current.csr.findIndex(stops[i]), current.csr.findIndex(stops[i + 1]));
+		if (weight == INF) return true;
+		dists.push_back(weight);
+		*totalDist += weight;
 	}
 
 	return false;
@@ -135,11 +133,12 @@ bool Manager::invalidPath(Graph &g, std::vector<int> &stops, std::vector<double>
  * is added to the mst.
  * After this, a euler walk is generated and from this, an hamilton circuit.
  * As some graph are not fully connected, a valid path is not guaranteed.
- * @param base Base vertex where the tour will be started.
+ * @param base Id of the base vertex, where the tour will be started.
  * @note Complexity: O(E log V)
  * @return Structure with the time taken, stops, distances between stops and max distance travelled.
+ * If no valid path was found, the time and distance are -2, and -1 if the base is not a vertex.
 */
-ReturnDataTSP Manager::realWorldHeuristic(Vertex *base)
+ReturnDataTSP Manager::realWorldHeuristic(int base) const
 {
 	auto start = std::chrono::high_resolution_clock::now();
 	double totalDistance = 0;
@@ -147,39 +146,30 @@ ReturnDataTSP Manager::realWorldHeuristic(Vertex *base)
 	std::vector<double> distances;
 
 	// create mst
-	Graph mst = PrimMST(network, base);
+	int baseIdx = current.csr.findIndex(base);
+	if (baseIdx == -1) return {-1, {}, {}, -1};
+	std::shared_ptr<const SpanningTree> tree = networkMST(baseIdx);
+	const SpanningTree &mst = *tree;
 
 	// perfect match odd nodes
-	std::vector<Edge *> matches = perfectMatching(mst);
+	std::vector<CSREdge> matches = perfectMatching(mst);
 
-	// join edges to mst
-	for (auto edg : matches)
-	{
-		mst.addBidirectionalEdge(
-			edg->getDest()->getId(),
-			edg->getOrig()->getId(),
-			edg->getWeight()
-		);
-	}
+	// join edges to mst, both added in each direction by the multigraph
+	std::vector<CSREdge> edges = matches;
+	for (int v = 0; v < (int)mst.parent.size(); v++)
+		if (mst.parent[v] != -1) edges.push_back({mst.parent[v], v, mst.weight[v]});
+	CSRGraph multigraph(current.csr.getIds(), edges, true);
 
 	// do euler path
-	Vertex *mstBase = mst.findVertex(base->getId());
-	std::vector<Vertex *> eulerStops = eulerPath(mstBase);
+	std::vector<int> eulerStops = eulerPath(multigraph, baseIdx);
 
-	// do hamilton path
-	stops = hamilton(eulerStops);
-	stops.push_back(base->getId());
+	// do hamilton path, starting and ending at the base
+	stops = hamilton(multigraph, eulerStops);
+	std::rotate(stops.begin(), std::find(stops.begin(), stops.end(), base), stops.end());
+	stops.push_back(base);
 
-	if (invalidPath(network, stops, distances, &totalDistance))
-	{
-		UI::showMessage(
-			"NO AVAILABLE PATH",
-			"The algorithm was not able to find a valid path."
-		);
-		return {-2, {}, {}, -2};
-	}
+	if (invalidPath(stops, distances, &totalDistance)) return {-2, {}, {}, -2};
 
 	auto end = std::chrono::high_resolution_clock::now();
-	mst.resetGraph();
 	return {std::chrono::duration<double>(end - start).count(), stops, distances, totalDistance};
 }
@@ -1,119 +1,84 @@
 #include "../manager.h"
 
+/** Key of the Borůvka tree among the cached trees, which has no base and must not match any vertex index. */
+#define BORUVKA_MST_KEY std::numeric_limits<int>::min()
+
 /**
- * Creates a minimum span tree using Prim's Algorithm.
- * Uses the default graph
- * @note Complexity: O(E log V)
- * @param g Base graph to operate on.
- * @param base Pointer to starting vertex.
+ * Creates a minimum span tree of the network with the selected algorithm,
+ * taking implicitly completed edges into account.
+ * Trees are kept with the dataset, so later runs from the same base reuse them.
+ * @param base Index of the starting vertex, which must be a vertex of the network.
+ * @return Tree with its children linked, rooted at the base for Prim's algorithm.
+ * @note Complexity: O(V^2) if implicitly completed, O(E log V) otherwise, O(log V) if already built.
 */
-Graph Manager::PrimMST(Graph &g, Vertex *base)
+std::shared_ptr<const SpanningTree> Manager::networkMST(int base) const
 {
-	Graph mst;
-	std::priority_queue<Vertex *> queue;
-
-	base->setDist(0);
-	for (auto vtx : g.getVertexSet())
-	{
-		mst.addVertex(vtx->getId(), vtx->getInfo());
-		vtx->setPath(nullptr);
-		vtx->setVisited(false);
-		vtx->setDist(__DBL_MAX__);
-	}
-
-	queue.push(base);
-	while (!queue.empty())
-	{
-		Vertex *u = queue.top();
-		queue.pop();
-		if (u->isVisited()) continue;
-		u->setVisited(true);
-
-		for (auto e : u->getAdj())
-		{
-			Vertex *v = e->getDest();
-			if (!v->isVisited() && e->getWeight() < v->getDist())
-			{
-				v->setPath(e);
-				queue.push(v);
-				v->setDist(e->getWeight());
-			}
-		}
-	}
-
-	for (auto vtx : g.getVertexSet())
+	int key = mstAlgorithm == boruvka_mst ? BORUVKA_MST_KEY : base;
 	{
-		Edge *edg = vtx->getPath();
-		if (edg == nullptr) continue;
-		mst.addBidirectionalEdge(edg->getDest()->getId(), edg->getOrig()->getId(), edg->getWeight());
+		std::lock_guard<std::mutex> lock(mstMutex);
+		auto it = current.msts.find(key);
+		if (it != current.msts.end()) return it->second;
 	}
 
-	return mst;
+	auto mst = std::make_shared<const SpanningTree>(mstAlgorithm == boruvka_mst ? BoruvkaMST(mstThreads)
+		: current.implicitlyCompleted ? PrimMSTComplete(base) : PrimMST(current.csr, base));
+	std::lock_guard<std::mutex> lock(mstMutex);
+	return current.msts.emplace(key, mst).first->second;
 }
 
 /**
- * Depth-first search though a graph (in this case a Minimum-span tree), 
- * calculating the distance between stops and saving them.
- * @param vtx First vertex.
- * @param last Vertex processed before, nullptr if vtx is the first.
- * @param stops Vector to be filled with the stops
- * @param distances Vector to be filled with the distances between stops
- * @param total Pointer to a value where the total distance will be saved.
- * @note Complexity: O(V + E) 
+ * Selects the algorithm that builds the minimum spanning trees of the network,
+ * used by the triangular approximation and the real world heuristic.
+ * Both build a minimum tree, but may pick different edges among ones of equal weight.
+ * @param algorithm Prim's algorithm (sequential) or Borůvka's (parallel).
+ * @param threads Number of threads of Borůvka's algorithm, 0 meaning one per hardware thread.
 */
-void Manager::trianApproxDfs(Vertex *vtx, Vertex *last, std::vector<int> &stops, 
-	std::vector<double> &distances, double *total)
+void Manager::setMSTAlgorithm(MSTAlgorithm algorithm, unsigned threads)
 {
-	vtx->setVisited(true);
-	stops.push_back(vtx->getId());
+	mstAlgorithm = algorithm;
+	mstThreads = threads;
+}
 
-	if (last != nullptr)
-	{
-		Edge *edg = last->getEdgeTo(vtx);
-		double dist = edg == nullptr ? 0 : edg->getWeight();
-		distances.push_back(dist);
-		*total += dist;
-	}
-	
-	for (auto edg : vtx->getAdj())
-	{
-		Vertex *v = edg->getDest();
-		if (v->isVisited()) continue;
-		trianApproxDfs(v, vtx, stops, distances, total);
-	}
+/**
+ * @return Algorithm that builds the minimum spanning trees of the network.
+*/
+MSTAlgorithm Manager::getMSTAlgorithm() const
+{
+	return mstAlgorithm;
 }
 
 /**
  * Uses a minimum-span tree (MST) to approximate the vertexes 
  * and calculate a solution to the Salesman Travelling Problem.
- * @note Complexity: O(V + E)
+ * The stops are the preorder of the tree, walked through its child arrays,
+ * each one reached directly from the one before.
+ * @note Complexity: O(V) once the tree is built
  * @return Structure containing the time elapsed, vector with stops, 
  * vector with distances between those stops (in order) and total distance travelled.
 */
-ReturnDataTSP Manager::triangularApproximationHeuristic()
+ReturnDataTSP Manager::triangularApproximationHeuristic() const
 {
 	auto start = std::chrono::high_resolution_clock::now();
 	double totalDistance = 0;
 	std::vector<int> stops;
 	std::vector<double> distances;
-	Vertex *base = network.getVertexSet().front();
-	Graph mst = PrimMST(network, base);
-
-	for (auto vtx : network.getVertexSet()) vtx->setVisited(false);
+	int base = 0;
+	std::shared_ptr<const SpanningTree> tree = networkMST(base);
 
-	Vertex *mstBase = mst.findVertex(base->getId());
-	trianApproxDfs(mstBase, nullptr, stops, distances, &totalDistance);
+	std::vector<int> order = tree->preorder(base);
+	order.push_back(base);
 
-	Vertex *last = network.findVertex(stops.back());
-	stops.push_back(base->getId());
-	Edge *lastEdge = last->getEdgeTo(base);
-	double lastDist = lastEdge == nullptr ? 0 : lastEdge->getWeight();
-	distances.push_back(lastDist);
-	totalDistance += lastDist;
+	stops.push_back(current.csr.getId(base));
+	for (size_t i = 1; i < order.size(); i++)
+	{
+		double dist = distance(order[i - 1], order[i]);
+		if (dist == INF) dist = 0;
+		stops.push_back(current.csr.getId(order[i]));
+		distances.push_back(dist);
+		totalDistance += dist;
+	}
 
 	auto end = std::chrono::high_resolution_clock::now();
-	mst.resetGraph();
 	
 	return {std::chrono::duration<double>(end - start).count(), stops, distances, totalDistance};
 }
-
@@ -1,9 +1,6 @@
 #include "../manager.h"
 #include <cmath>
 
-#define PI 3.14159265
-#define EARTH_RADIUS 6371000
-
 /**
  * Overload for the haversineDistance function taking two graph Info elements.
  * Uses Haversine formula to calculate the distance between two coordinates.
@@ -11,7 +8,7 @@
  * @param pos1 Information about 1st vertex
  * @param pos2 Information about 2nd vertex 
 */
-double Manager::haversineDistance(Info pos1, Info pos2)
+double Manager::haversineDistance(const Info &pos1, const Info &pos2)
 {
 	if (pos1.lat == -1 || pos2.lat == -1 
 		|| pos1.lon == -1 || pos2.lon == -1) return -1;
@@ -53,6 +50,119 @@ double Manager::haversineDistance(double lat1, double lon1,
 	return EARTH_RADIUS * 2.0 * atan2(sqrt(aux), sqrt(1.0 - aux));
 }
 
+/**
+ * Distance between two vertexes of the current graph.
+ * Uses the distance matrix when the graph is fully connected,
+ * otherwise searches the CSR adjacency.
+ * If the graph is implicitly completed, missing edges are replaced
+ * by the haversine distance between both vertexes, read from the packed
+ * distance matrix or, for graphs too large for it, computed from the 
+ * precomputed trigonometry table through a bounded per-thread cache.
+ * @param orig Dense index of the origin.
+ * @param dest Dense index of the destination.
+ * @return Distance, or INF if the vertexes are not connected.
+ * @note Complexity: O(1) with the distance matrix, O(log V) otherwise.
+*/
+double Manager::distance(int orig, int dest) const
+{
+	if (!current.matrix.empty()) return current.matrix.get(orig, dest);
+
+	double weight = current.csr.getWeight(orig, dest);
+	if (weight != INF || !current.implicitlyCompleted || orig == dest) return weight;
+	if (!current.packed.empty()) return current.packed.get(orig, dest);
+
+	// Each thread has its own cache, so parallel runs never share one.
+	// It is emptied when it was filled for another completion.
+	thread_local DistanceCache cache;
+	thread_local uint64_t cacheGeneration = 0;
+	if (cacheGeneration != current.completionGeneration)
+	{
+		cache.clear();
+		cacheGeneration = current.completionGeneration;
+	}
+
+	if (cache.find(orig, dest, weight)) return weight;
+	weight = current.geo.distance(orig, dest);
+	cache.insert(orig, dest, weight);
+	return weight;
+}
+
+/**
+ * Distance from a vertex to every vertex of the current graph, 
+ * with the same values as Manager::distance.
+ * Implicitly completed rows are computed with the vectorized haversine kernel.
+ * @param orig Dense index of the origin.
+ * @param out Resized to V and filled with the distance to each dense index.
+ * @note Complexity: O(V)
+*/
+void Manager::distanceRow(int orig, std::vector<double> &out) const
+{
+	int n = current.csr.getNumVertex();
+	out.resize(n);
+
+	if (!current.matrix.empty())
+	{
+		std::copy(current.matrix.row(orig), current.matrix.row(orig) + n, out.begin());
+		return;
+	}
+
+	if (current.implicitlyCompleted) 
+	{
+		// Rounded like the packed matrix, so both functions always agree
+		current.geo.distanceRow(orig, 0, n, out.data());
+		if (!current.packed.empty())
+			for (int k = 0; k < n; k++) out[k] = (float)out[k];
+	}
+	else std::fill(out.begin(), out.end(), INF);
+
+	for (size_t e = current.csr.edgeEnd(orig); e-- > current.csr.edgeBegin(orig);)
+		out[current.csr.getDest(e)] = current.csr.getWeight(e);
+	out[orig] = distance(orig, orig);
+}
+
+/**
+ * Lists the nearest vertexes of every vertex by haversine distance, using the spatial index.
+ * Meant for searches that only need to look at close vertexes.
+ * @param k Number of candidates per vertex, limited to V - 1.
+ * @return Flat list where the candidates of vertex v are at [v * k, (v + 1) * k), 
+ * closest first. Empty if the vertexes have no coordinates.
+ * @note Complexity: O(V (k log k + log V)) on average
+*/
+std::vector<int> Manager::candidateLists(int k) const
+{
+	int n = current.kdtree.size();
+	k = std::min(k, n - 1);
+	if (k <= 0) return {};
+
+	std::vector<int> lists((size_t)n * k);
+	parallelFor(0, n, [&](size_t v, unsigned) {
+		current.kdtree.nearest(v, k, lists.data() + v * k);
+	}, 0, 64);
+	return lists;
+}
+
+/**
+ * Builds the result of a heuristic from a tour given by vertex indexes.
+ * @param order Vertex indexes of the tour, starting and ending at the same vertex.
+ * @param processingTime Time taken to find the tour.
+ * @return Structure with the time taken, stops, distances between stops and total distance travelled.
+ * @note Complexity: O(V) with the distance matrix, O(V log V) otherwise.
+*/
+ReturnDataTSP Manager::tourOf(const std::vector<int> &order, double processingTime) const
+{
+	std::vector<int> stops;
+	std::vector<double> distances;
+	double totalDistance = 0;
+	for (size_t i = 0; i < order.size(); i++)
+	{
+		stops.push_back(current.csr.getId(order[i]));
+		if (i == 0) continue;
+		distances.push_back(distance(order[i - 1], order[i]));
+		totalDistance += distances.back();
+	}
+	return {processingTime, stops, distances, totalDistance};
+}
+
 /**
  * Checks if a graph is fully connected 
  * by checking if all vertexes have (count of vertexes - 1) edges.~
@@ -61,22 +171,45 @@ double Manager::haversineDistance(double lat1, double lon1,
 */
 bool Manager::isGraphFullyConnected()
 {
-	size_t vertexCount = network.getNumVertex();
-	for (auto vtx : network.getVertexSet())
+	size_t vertexCount = current.csr.getNumVertex();
+	for (int v = 0; v < current.csr.getNumVertex(); v++)
 	{
-		if (vtx->getAdj().size() != vertexCount - 1) return false;
+		if (current.csr.getDegree(v) != vertexCount - 1) return false;
 	}
 	return true;
 }
 
+/**
+ * Makes the graph behave as fully connected without adding any edge.
+ * The explicit edges are kept and every missing distance comes
+ * from the coordinates of the vertexes (see Manager::distance),
+ * through the packed distance matrix when the graph is not too large.
+ * Only possible if every vertex has coordinates.
+ * @note Complexity: O(V^2) to compute the packed matrix, O(1) if it is mapped
+*/
+void Manager::implicitlyCompleteGraph()
+{
+	if (!canImplicitlyComplete()) return;
+	loadPackedMatrix();
+	static std::atomic<uint64_t> generations(0);
+	{
+		std::lock_guard<std::mutex> lock(mstMutex);
+		current.msts.clear();
+	}
+	current.implicitlyCompleted = true;
+	current.completionGeneration = ++generations;
+}
+
 /**
  * Shows a screen with information about the graph connection process.
  * Intented to be run in a separated thread.
- * @param active Pointer to boolean indicating if the process is active.
- * @param vtxnum Pointer to the number of vertexes already processed.
+ * @param active Indicates if the process is active.
+ * @param vtxnumb Number of vertexes already processed.
+ * @param merged Number of new edges already added to the graph.
  * @param total Total number of vertexes.
 */
-void thrLoadScreen2(bool *active, long *vtxnumb, long total)
+void thrLoadScreen2(const std::atomic<bool> *active, const std::atomic<long> *vtxnumb,
+	const std::atomic<long> *merged, long total)
 {
 	auto start = std::chrono::high_resolution_clock::now();
 	CLEAR;
@@ -86,35 +219,71 @@ void thrLoadScreen2(bool *active, long *vtxnumb, long total)
 	{
 		auto now = std::chrono::high_resolution_clock::now();
 		auto elapsed = std::chrono::duration<double>(now - start).count();
-		std::cout << RESET << *vtxnumb << " of " << total 
+		std::cout << RESET << vtxnumb->load() << " of " << total 
+			<< " | " << merged->load() << " edges added"
 			<< " | " << std::fixed << std::setprecision(1) << elapsed << "s";
 		PAUSE(100);
-	} while (*active);
+	} while (active->load());
 }
 
 /**
  * Fully connects graph.
+ * The vertexes are taken in blocks. The missing edges of the vertexes of a block are found
+ * by worker threads, each vertex filling its own edge buffer. If the vertexes have coordinates,
+ * their distances are computed a whole row at a time by the vectorized haversine kernel.
+ * The buffers are then merged into the graph by a single thread, as adding an edge
+ * also changes the incoming edges of its destination, and freed before the next block,
+ * so only a block of rows is held besides the graph.
+ * Every vertex ends with n - 1 edges each way, which are reserved before merging,
+ * so the edge lists do not grow inside the graph arena.
  * @note Complexity: O(n ^ 2)
 */
 void Manager::fullyConnectGraph()
 {
-	bool active = true;
-	long vtxnumb = 0;
-	size_t vertexCount = network.getNumVertex();
+	buildNetwork();
+	std::atomic<bool> active(true);
+	std::atomic<long> vtxnumb(0);
+	std::atomic<long> merged(0);
+	size_t vertexCount = current.network.getNumVertex();
+	const std::vector<Vertex *> &vertexes = current.network.getVertexSet();
+	unsigned threads = getThreadCount();
+	const size_t blockSize = 256;
+	std::vector<std::vector<CSREdge>> buffers(blockSize);
+	std::vector<std::vector<double>> rows(threads, std::vector<double>(vertexCount));
 	std::thread loader = std::thread(thrLoadScreen2, 
-		&active, &vtxnumb, vertexCount);
+		&active, &vtxnumb, &merged, vertexCount);
 
-	for (auto& vtx : network.getVertexSet())
+	for (Vertex *vtx : vertexes) vtx->reserveEdges(vertexCount - 1);
+	for (size_t first = 0; first < vertexCount; first += blockSize)
 	{
-		vtxnumb++;
-		if (vtx->getAdj().size() == vertexCount - 1) continue;
-		for (auto& vtx2 : network.getVertexSet())
+		size_t last = std::min(first + blockSize, vertexCount);
+		parallelFor(first, last, [&](size_t i, unsigned thread) {
+			Vertex *vtx = vertexes[i];
+			std::vector<double> &row = rows[thread];
+			vtxnumb++;
+			if (vtx->getAdj().size() == vertexCount - 1) return;
+			if (!current.geo.empty()) current.geo.distanceRow(i, 0, vertexCount, row.data());
+
+			for (size_t j = 0; j < vertexCount; j++)
+			{
+				if (i == j) continue;
+				if (vtx->getEdgeTo(vertexes[j]) != nullptr) continue;
+			
+				double dist = current.geo.empty() 
+					? Manager::haversineDistance(vtx->getInfo(), vertexes[j]->getInfo()) 
+					: row[j];
+				buffers[i - first].push_back({(int)i, (int)j, dist});
+			}
+		}, threads, 16);
+
+		for (size_t i = first; i < last; i++)
 		{
-			if (vtx == vtx2) continue;
-			if (vtx->getEdgeTo(vtx2) != nullptr) continue;
-		
-			double dist = Manager::haversineDistance(vtx->getInfo(), vtx2->getInfo());
-			vtx->addEdge(vtx2, dist);
+			for (auto &edg : buffers[i - first])
+			{
+				vertexes[edg.orig]->addEdge(vertexes[edg.dest], edg.weight);
+				merged++;
+			}
+			std::vector<CSREdge>().swap(buffers[i - first]);
 		}
 	}
 
@@ -122,5 +291,5 @@ void Manager::fullyConnectGraph()
 	loader.join();
 
 	std::cout << "\nVerifying success...\n";
-	fullyConnected = isGraphFullyConnected();
+	buildDerivedStructures();
 }
@@ -0,0 +1,67 @@
+#ifndef LOAD_JOB_H
+#define LOAD_JOB_H
+
+#include "dataset.h"
+#include <atomic>
+#include <future>
+#include <string>
+
+/**
+ * Counters updated by a dataset load as it goes, readable from any thread.
+*/
+struct LoadProgress {
+	/** Size of the files being parsed, in bytes. */
+	std::atomic<size_t> bytesTotal{0};
+
+	/** Bytes parsed so far. */
+	std::atomic<size_t> bytesParsed{0};
+
+	/** Vertexes read so far. */
+	std::atomic<size_t> vertexes{0};
+
+	/** Edges read so far. */
+	std::atomic<size_t> edges{0};
+
+	/** Set to ask the load to stop. */
+	std::atomic<bool> cancelled{false};
+};
+
+/**
+ * Handle to a dataset being loaded by a worker thread, into a dataset of its own.
+ * Jobs are started and collected by the manager (see Manager::startLoad),
+ * which then selects or caches the loaded dataset.
+*/
+class LoadJob {
+public:
+	LoadJob(DatasetType type, int option) : type(type), option(option) {}
+
+	DatasetType getType() const { return type; }
+	int getOption() const { return option; }
+	const LoadProgress& getProgress() const { return progress; }
+
+	/** Asks the worker to stop. The job then finishes without a dataset. */
+	void cancel() { progress.cancelled = true; }
+	bool isCancelled() const { return progress.cancelled; }
+
+	/** @return True once the worker finished, so that collecting the job does not block. */
+	bool isDone() const { return done.wait_for(std::chrono::seconds(0)) == std::future_status::ready; }
+	void wait() const { done.wait(); }
+
+	/** @return Why the dataset could not be loaded, empty if it was. Valid once done. */
+	const std::string& getError() const { return error; }
+
+private:
+	friend class Manager;
+
+	DatasetType type;
+	int option;
+	LoadProgress progress;
+	std::string error;
+	Dataset result;
+
+	/** True if the dataset was in the cache, so there is nothing to load. */
+	bool cached = false;
+	std::future<void> done;
+};
+
+#endif
@@ -1,61 +1,162 @@
 #include "manager.h"
+#include "csv.h"
+#include "snapshot.h"
+#include <cstring>
 #include "../ui/ui.h"
 
+/** Smallest edges file, in bytes, parsed by several threads. */
+#define PARALLEL_LOAD_MIN_SIZE (1 << 20)
+
+/** Number of rows read between checks for cancellation and progress updates. */
+#define PROGRESS_ROWS 4096
+
 /**
- * Loads a dataset of type Toy
- * @param option Which toy dataset [1 = shipping, 2 = stadiums, 3 = tourism]
- * @note Complexity: O(E)
+ * Rows parsed from a chunk of an edges file.
 */
-void Manager::loadToy(unsigned option)
+struct ParsedChunk {
+	/** Valid rows, as edges between vertex ids. */
+	std::vector<CSREdge> edges;
+
+	/** Line numbers of the malformed rows, relative to the chunk. */
+	std::vector<size_t> invalidLines;
+
+	/** Number of lines in the chunk. */
+	size_t lines = 0;
+};
+
+/**
+ * Checks that a dataset file could be opened.
+ * The program exits if it couldn't, as the datasets are required,
+ * unless the load is a background job, which then fails.
+ * @param file The file, memory-mapped.
+ * @param fileName Path to the file.
+ * @return True if the file is open.
+*/
+bool Manager::openDatasetFile(MappedFile &file, const std::string &fileName)
 {
-	std::string fileName;
-	switch (option)
+	if (file.isOpen()) 
 	{
-		case 1:
-			fileName = "./datasets/toy/shipping.csv";
-			break;
-		case 2:
-			fileName = "./datasets/toy/stadiums.csv";
-			break;
-		case 3:
-			fileName = "./datasets/toy/tourism.csv";
-			break;
+		if (loadJob != nullptr) loadJob->progress.bytesTotal += file.size();
+		return true;
 	}
-	std::ifstream file = std::ifstream(fileName);
-
-    if(!file.is_open())
+	if (loadJob != nullptr)
 	{
-		CLEAR;
-        std::cout << "Error while opening file: " << fileName << std::endl;
-		exit(0);
-    }
-	else
+		loadJob->error = "Error while opening file: " + fileName;
+		loadJob->cancel();
+		return false;
+	}
+	CLEAR;
+	std::cout << "Error while opening file: " << fileName << std::endl;
+	exit(0);
+}
+
+/**
+ * @return True if the background job this dataset is loaded for was cancelled.
+*/
+bool Manager::loadCancelled() const
+{
+	return loadJob != nullptr && loadJob->isCancelled();
+}
+
+/**
+ * Adds to the progress counters of the background job this dataset is loaded for, if any.
+ * @param bytes Bytes parsed.
+ * @param vertexes Vertexes read.
+ * @param edges Edges read.
+*/
+void Manager::reportProgress(size_t bytes, size_t vertexes, size_t edges)
+{
+	if (loadJob == nullptr) return;
+	loadJob->progress.bytesParsed.fetch_add(bytes, std::memory_order_relaxed);
+	loadJob->progress.vertexes.fetch_add(vertexes, std::memory_order_relaxed);
+	loadJob->progress.edges.fetch_add(edges, std::memory_order_relaxed);
+}
+
+/**
+ * Records a row of a dataset file that could not be read and was skipped.
+ * Only the first MAX_LOAD_WARNINGS rows are described.
+ * @param fileName Path to the file.
+ * @param line Line number of the row.
+*/
+void Manager::addLoadWarning(const std::string &fileName, size_t line)
+{
+	current.skippedRows++;
+	if (current.loadWarnings.size() >= MAX_LOAD_WARNINGS) return;
+	std::ostringstream out;
+	out << fileName << ":" << line << ": malformed row, skipped";
+	current.loadWarnings.push_back(out.str());
+}
+
+/**
+ * Files a dataset is loaded from.
+ * @param type Type of the dataset
+ * @param option Option of the dataset, as in loadDataset
+ * @return Paths of the files, the nodes file first for the extra and real world datasets.
+*/
+std::vector<std::string> Manager::datasetFiles(DatasetType type, int option)
+{
+	std::ostringstream path;
+	switch (type)
 	{
-        std::string line;
-        std::getline(file, line);
+		case none:
+			return {};
+		case toy_shipping:
+			return {"./datasets/toy/shipping.csv"};
+		case toy_stadiums:
+			return {"./datasets/toy/stadiums.csv"};
+		case toy_tourism:
+			return {"./datasets/toy/tourism.csv"};
+		case extra:
+			path << "./datasets/extra_fully_connected/edges_" << option << ".csv";
+			return {"./datasets/extra_fully_connected/nodes.csv", path.str()};
+		case real_world:
+			path << "./datasets/real_world/graph" << option << "/";
+			return {path.str() + "nodes.csv", path.str() + "edges.csv"};
+	}
+	return {};
+}
+
+/**
+ * Loads a dataset of type Toy, from its snapshot if it is up to date.
+ * @param option Which toy dataset [1 = shipping, 2 = stadiums, 3 = tourism]
+ * @note Complexity: O(E)
+*/
+void Manager::loadToy(unsigned option)
+{
+	static const DatasetType TYPES[] = {toy_shipping, toy_stadiums, toy_tourism};
+	std::string fileName = datasetFiles(TYPES[option - 1], -1).front();
+	current.addSource(fileName);
+	if (readSnapshot(fileName + ".snap", {fileName}, option)) return;
 
-        while (getline(file, line))
+	MappedFile file(fileName);
+	if (!openDatasetFile(file, fileName)) return;
+
+	CsvReader reader(file.begin(), file.end());
+	reader.nextRow();
+	const char *reported = file.begin();
+
+	while (reader.nextRow())
+	{
+		if (loadCancelled()) return;
+		reportProgress(reader.getPosition() - reported, 0, 0);
+		reported = reader.getPosition();
+		int o, d;
+		double w;
+		std::string_view label1, label2;
+		bool valid = reader.readInt(o) && reader.readInt(d) && reader.readDouble(w);
+		if (valid && option == 3) valid = reader.readText(label1) && reader.readText(label2);
+		if (!valid || !reader.rowEnded())
 		{
-            std::string origin, dest, distance, label1 = "", label2 = "";
-            std::stringstream ss(line);
+			addLoadWarning(fileName, reader.getLine());
+			continue;
+		}
 
-            std::getline(ss, origin, ',');
-            std::getline(ss, dest, ',');
-            std::getline(ss, distance, option == 3 ? ',' : '\r');
-            if (option == 3) 
-			{
-				std::getline(ss, label1, ',');
-            	std::getline(ss, label2, '\r');
-			}
-			
-			int o = std::stoi(origin);
-			int d = std::stoi(dest);
-			double w = std::stod(distance);
-			network.addVertex(o, Info(label1));
-			network.addVertex(d, Info(label2));
-            network.addBidirectionalEdge(o, d, w);
-        }
-    }
+		size_t added = current.network.addVertex(o, Info(std::string(label1)));
+		added += current.network.addVertex(d, Info(std::string(label2)));
+		current.network.addBidirectionalEdge(o, d, w);
+		reportProgress(0, added, 1);
+	}
+	writeSnapshot(fileName + ".snap", {fileName}, option);
 }
 
 /**
@@ -65,10 +166,8 @@ void Manager::loadToy(unsigned option)
 */
 void Manager::loadExtra(unsigned option)
 {
-	std::string nodes = "./datasets/extra_fully_connected/nodes.csv";
-	std::ostringstream edges;
-	edges << "./datasets/extra_fully_connected/edges_" << option << ".csv";
-	loadBig(nodes, edges.str(), true, true, option);
+	std::vector<std::string> files = datasetFiles(extra, option);
+	loadBig(files[0], files[1], true, true, option);
 }
 
 /**
@@ -78,15 +177,17 @@ void Manager::loadExtra(unsigned option)
 */
 void Manager::loadRealWorld(unsigned option)
 {
-	std::ostringstream path;
-	path << "./datasets/real_world/graph" << option << "/";
-	std::string nodes = path.str() + "nodes.csv";
-	std::string edges = path.str() + "edges.csv";
-	loadBig(nodes, edges, false, true, -1);
+	std::vector<std::string> files = datasetFiles(real_world, option);
+	loadBig(files[0], files[1], false, true, -1);
 }
 
 /**
  * Reads and loads a graph based in two files containing edges and nodes.
+ * If they did not change since they were last loaded, their snapshot is used instead.
+ * Otherwise both files are memory-mapped and parsed in place.
+ * Large edges files are split in newline-aligned chunks parsed by worker threads,
+ * then their edges are added to the graph in file order.
+ * Malformed rows are skipped and reported as load warnings.
  * @note Complexity: O(V + E)
  * @param nodes Path to the Nodes file.
  * @param edges Path to the Edges file.
@@ -97,81 +198,175 @@ void Manager::loadRealWorld(unsigned option)
 void Manager::loadBig(std::string nodes, std::string edges, bool skipFirstRow, 
 	bool assumeBidirectional, long rowCount = -1)
 {
-	std::ifstream file = std::ifstream(nodes);
+	current.coordinatesFile = nodes;
+	current.coordinatesRows = rowCount;
+	int64_t params = (int64_t)rowCount * 4 + skipFirstRow * 2 + assumeBidirectional;
+	current.addSource(nodes);
+	current.addSource(edges);
+	if (readSnapshot(edges + ".snap", {nodes, edges}, params)) return;
 
-    if(!file.is_open())
 	{
-		CLEAR;
-        std::cout << "Error while opening file: " << nodes << std::endl;
-		exit(0);
-    }
-	else
-	{
-        std::string line;
-        std::getline(file, line);
+		MappedFile file(nodes);
+		if (!openDatasetFile(file, nodes)) return;
+
+		CsvReader reader(file.begin(), file.end());
+		reader.nextRow();
 
-		int count = 0;
-        while (getline(file, line) && (count < rowCount || rowCount == -1))
+		long count = 0, reportedCount = 0;
+		const char *reported = file.begin();
+		while ((count < rowCount || rowCount == -1) && reader.nextRow())
 		{
-            std::string origin, longi, lat;
-            std::stringstream ss(line);
-
-            std::getline(ss, origin, ',');
-            std::getline(ss, longi, ',');
-            std::getline(ss, lat, '\r');
-			
-			int o = std::stoi(origin);
-			double lo = std::stod(longi);
-			double la = std::stod(lat);
-			network.addVertex(o, Info(lo, la));
+			if (reader.getLine() % PROGRESS_ROWS == 0)
+			{
+				if (loadCancelled()) return;
+				reportProgress(reader.getPosition() - reported, count - reportedCount, 0);
+				reported = reader.getPosition();
+				reportedCount = count;
+			}
+			int o;
+			double lo, la;
+			if (!reader.readInt(o) || !reader.readDouble(lo) || !reader.readDouble(la) 
+				|| !reader.rowEnded())
+			{
+				addLoadWarning(nodes, reader.getLine());
+				continue;
+			}
+			current.network.addVertex(o, Info(lo, la));
 			count++;
-        }
-    }
+		}
+		reportProgress(file.end() - reported, count - reportedCount, 0);
+	}
 
-	file = std::ifstream(edges);
+	MappedFile file(edges);
+	if (!openDatasetFile(file, edges)) return;
 
-    if(!file.is_open())
+	// Skip the header, so that every chunk only has data rows
+	const char *first = file.begin();
+	size_t firstLine = 1;
+	if (!skipFirstRow)
 	{
-		CLEAR;
-        std::cout << "Error while opening file: " << edges << std::endl;
-		exit(0);
-    }
-	else
+		const char *newline = static_cast<const char *>(memchr(first, '\n', file.size()));
+		first = newline == nullptr ? file.end() : newline + 1;
+		firstLine = 2;
+	}
+
+	reportProgress(first - file.begin(), 0, 0);
+
+	// Parse newline-aligned chunks in parallel, each into its own arrays
+	size_t chunkCount = file.size() < PARALLEL_LOAD_MIN_SIZE ? 1 : getThreadCount() * 4;
+	std::vector<const char *> bounds = CsvReader::splitChunks(first, file.end(), chunkCount);
+	chunkCount = bounds.size() - 1;
+	std::vector<ParsedChunk> chunks(chunkCount);
+
+	parallelFor(0, chunkCount, [&](size_t c, unsigned) {
+		if (loadCancelled()) return;
+		CsvReader reader(bounds[c], bounds[c + 1]);
+		ParsedChunk &chunk = chunks[c];
+		while (reader.nextRow())
+		{
+			CSREdge edg;
+			if (!reader.readInt(edg.orig) || !reader.readInt(edg.dest) 
+				|| !reader.readDouble(edg.weight) || !reader.rowEnded())
+			{
+				chunk.invalidLines.push_back(reader.getLine());
+				continue;
+			}
+			chunk.edges.push_back(edg);
+		}
+		chunk.lines = reader.getLine();
+		reportProgress(bounds[c + 1] - bounds[c], 0, chunk.edges.size());
+	});
+	if (loadCancelled()) return;
+
+	// Add the edges in file order, so the graph does not depend on the number of threads
+	for (auto &chunk : chunks)
 	{
-        std::string line;
-        if (!skipFirstRow) std::getline(file, line);
+		for (size_t line : chunk.invalidLines)
+			addLoadWarning(edges, firstLine + line - 1);
+		firstLine += chunk.lines;
 
-        while (getline(file, line))
+		for (auto &edg : chunk.edges)
 		{
-            std::string sourc, dest, dist;
-            std::stringstream ss(line);
-
-            std::getline(ss, sourc, ',');
-            std::getline(ss, dest, ',');
-            std::getline(ss, dist, '\r');
-			
-			int s = std::stoi(sourc);
-			int d = std::stod(dest);
-			double w = std::stod(dist);
 			if (assumeBidirectional)
-				network.addBidirectionalEdge(s, d, w);
+				current.network.addBidirectionalEdge(edg.orig, edg.dest, edg.weight);
 			else
-				network.addEdge(s, d, w);
-        }
-    }
+				current.network.addEdge(edg.orig, edg.dest, edg.weight);
+		}
+		std::vector<CSREdge>().swap(chunk.edges);
+	}
+	writeSnapshot(edges + ".snap", {nodes, edges}, params);
+}
+
+/**
+ * Loads the current dataset from its snapshot, if there is an up to date one.
+ * The CSR graph is then a view of the snapshot and the pointer-based graph 
+ * is only built if needed (see Manager::getNetwork).
+ * @param path Path of the snapshot.
+ * @param sources Files the dataset is loaded from.
+ * @param params Loader parameters.
+ * @return True if the dataset was loaded.
+ * @note Complexity: O(V)
+*/
+bool Manager::readSnapshot(const std::string &path, const std::vector<std::string> &sources, 
+	int64_t params)
+{
+	if (!useSnapshots) return false;
+	if (!Snapshot::read(path, sources, params, current.csr, current.labels)) return false;
+	current.networkBuilt = false;
+	reportProgress(0, current.csr.getNumVertex(), current.csr.getNumEdges());
+	return true;
+}
+
+/**
+ * Saves the dataset just loaded into the graph as a snapshot.
+ * Nothing is saved if some rows were skipped, so that they are reported on every load.
+ * Failing to save is not an error, the dataset will simply be parsed again next time.
+ * @param path Path of the snapshot.
+ * @param sources Files the dataset was loaded from.
+ * @param params Loader parameters.
+ * @note Complexity: O(V + E log E)
+*/
+void Manager::writeSnapshot(const std::string &path, const std::vector<std::string> &sources, 
+	int64_t params)
+{
+	current.csr = CSRGraph(current.network);
+	if (!useSnapshots || current.skippedRows != 0 || loadCancelled()) return;
+
+	std::vector<std::string> vertexLabels;
+	for (auto vtx : current.network.getVertexSet())
+	{
+		if (vtx->getInfo().label.empty()) continue;
+		for (auto other : current.network.getVertexSet())
+			vertexLabels.push_back(other->getInfo().label);
+		break;
+	}
+	Snapshot::write(path, sources, params, current.csr, vertexLabels);
 }
 
 /**
  * Calls the appropriate loader function given the dataset.
- * Also calculates the time the system took to load it.
- * @note Complexity: O(V + E)
+ * Also calculates the time the system took to load it,
+ * including building the structures used by the heuristics.
+ * The dataset selected until now is kept in the cache, and a cached dataset
+ * is selected again without any I/O, unless its files changed.
+ * Selecting the current dataset again reloads it from its files.
+ * @note Complexity: O(V + E), O(V) if cached
  * @param type Type of the dataset to load
  * @param option defaults to -1. It is required to select a specific dataset of types RealWorld and Extra
 */
 void Manager::loadDataset(DatasetType type, int option)
 {
 	auto start = std::chrono::high_resolution_clock::now();
-	network.resetGraph();
+	collectPrefetched(type, option);
+	if (current.dType != type || current.option != option) cache.put(std::move(current));
+	current = Dataset();
+	if (cache.take(type, option, current))
+	{
+		auto end = std::chrono::high_resolution_clock::now();
+		current.loadtime = std::chrono::duration<double>(end - start).count();
+		return;
+	}
+
 	switch (type) {
 		case none:
 			return;
@@ -201,9 +396,296 @@ void Manager::loadDataset(DatasetType type, int option)
 			loadExtra(option);
 			break;
 	};
+	if (loadCancelled())
+	{
+		current = Dataset();
+		return;
+	}
+	buildFromCSR();
 	auto end = std::chrono::high_resolution_clock::now();
-	loadtime = std::chrono::duration<double>(end - start).count();
-	this->dType = type;
-	this->option = option;
-	this->fullyConnected = isGraphFullyConnected();
+	current.loadtime = std::chrono::duration<double>(end - start).count();
+	current.dType = type;
+	current.option = option;
+}
+
+/**
+ * Starts loading a dataset in a worker thread, into a dataset of its own,
+ * so that the current one stays usable meanwhile.
+ * A dataset already being prefetched is not loaded twice: its job is returned.
+ * @param type Type of the dataset to load
+ * @param option Option of the dataset, as in loadDataset
+ * @return Handle to the load, to be passed to finishLoad.
+*/
+std::shared_ptr<LoadJob> Manager::startLoad(DatasetType type, int option)
+{
+	for (auto it = prefetching.begin(); it != prefetching.end(); it++)
+	{
+		if ((*it)->type != type || (*it)->option != option) continue;
+		std::shared_ptr<LoadJob> job = *it;
+		prefetching.erase(it);
+		return job;
+	}
+
+	auto job = std::make_shared<LoadJob>(type, option);
+	if ((current.dType != type || current.option != option) && cache.contains(type, option))
+	{
+		std::promise<void> ready;
+		ready.set_value();
+		job->cached = true;
+		job->done = ready.get_future();
+		return job;
+	}
+
+	bool snapshots = useSnapshots;
+	LoadJob *target = job.get();
+	job->done = std::async(std::launch::async, [target, snapshots]() {
+		Manager worker;
+		worker.useSnapshots = snapshots;
+		worker.setCacheBudget(0);
+		worker.loadJob = target;
+		worker.loadDataset(target->type, target->option);
+		target->result = std::move(worker.current);
+	});
+	return job;
+}
+
+/**
+ * Waits for a load started by startLoad and selects the loaded dataset,
+ * keeping the current one in the cache.
+ * @param job Handle returned by startLoad.
+ * @return False if the load was cancelled or failed, the current dataset is then kept.
+*/
+bool Manager::finishLoad(const std::shared_ptr<LoadJob> &job)
+{
+	job->wait();
+	if (job->cached)
+	{
+		loadDataset(job->type, job->option);
+		return true;
+	}
+	if (job->isCancelled() || job->result.dType == none) return false;
+	adopt(std::move(job->result));
+	return true;
+}
+
+/**
+ * Selects a dataset loaded elsewhere, keeping the current one in the cache.
+ * @param dataset The dataset.
+*/
+void Manager::adopt(Dataset &&dataset)
+{
+	if (current.dType != dataset.dType || current.option != dataset.option) cache.put(std::move(current));
+	current = std::move(dataset);
+}
+
+/**
+ * Starts loading a dataset in the background, to be kept in the cache
+ * for when it is selected. Nothing is done if the dataset is already
+ * selected, cached or being loaded, or if the cache is disabled.
+ * Neither is it if the size of its files, taken as an estimate of its size,
+ * is more than the cache has left, so that it does not evict the datasets kept there.
+ * @param type Type of the dataset to load
+ * @param option Option of the dataset, as in loadDataset
+*/
+void Manager::prefetch(DatasetType type, int option)
+{
+	collectPrefetched(none, -1);
+	if (type == none || cache.getBudget() == 0) return;
+	if ((current.dType == type && current.option == option) || cache.contains(type, option)) return;
+	for (auto &job : prefetching)
+		if (job->type == type && job->option == option) return;
+
+	uintmax_t estimate = 0;
+	for (const std::string &file : datasetFiles(type, option))
+	{
+		std::error_code error;
+		uintmax_t size = std::filesystem::file_size(file, error);
+		if (!error) estimate += size;
+	}
+	if (estimate > cache.getBudget() - std::min(cache.getBudget(), cache.getMemoryUsage())) return;
+	prefetching.push_back(startLoad(type, option));
+}
+
+/**
+ * Moves the datasets whose background load finished into the cache.
+ * A load of the given dataset is waited for, since it is about to be selected.
+ * @param type Type of the dataset about to be selected
+ * @param option Option of the dataset about to be selected
+*/
+void Manager::collectPrefetched(DatasetType type, int option)
+{
+	for (auto it = prefetching.begin(); it != prefetching.end();)
+	{
+		LoadJob &job = **it;
+		bool wanted = job.type == type && job.option == option;
+		if (!wanted && !job.isDone())
+		{
+			it++;
+			continue;
+		}
+		job.wait();
+		if (!job.isCancelled()) cache.put(std::move(job.result));
+		it = prefetching.erase(it);
+	}
+}
+
+/**
+ * Finds the dataset listed after the given one in the dataset selection menu.
+ * @param type Type of the dataset, replaced by the type of the next one
+ * @param option Option of the dataset, replaced by the option of the next one
+ * @return False if it is the last dataset of the list.
+*/
+bool Manager::nextDataset(DatasetType &type, int &option)
+{
+	static const int EXTRA_OPTIONS[] = {25, 50, 75, 100, 200, 300, 400, 500, 600, 700, 800, 900};
+	switch (type)
+	{
+		case none:
+			return false;
+		case toy_shipping:
+			type = toy_stadiums;
+			return true;
+		case toy_stadiums:
+			type = toy_tourism;
+			return true;
+		case toy_tourism:
+			type = extra;
+			option = EXTRA_OPTIONS[0];
+			return true;
+		case extra:
+			for (size_t i = 0; i + 1 < sizeof(EXTRA_OPTIONS) / sizeof(int); i++)
+			{
+				if (EXTRA_OPTIONS[i] != option) continue;
+				option = EXTRA_OPTIONS[i + 1];
+				return true;
+			}
+			type = real_world;
+			option = 1;
+			return true;
+		case real_world:
+			if (option >= 3) return false;
+			option++;
+			return true;
+	}
+	return false;
+}
+
+/**
+ * Changes the memory budget of the dataset cache.
+ * @param bytes New budget, in bytes. Zero disables the cache.
+*/
+void Manager::setCacheBudget(size_t bytes)
+{
+	cache.setBudget(bytes);
+}
+
+/**
+ * @return The cache of the datasets loaded before the current one.
+*/
+const DatasetCache& Manager::getCache() const
+{
+	return cache;
+}
+
+/**
+ * Rebuilds the structures the heuristics run on from the current graph.
+ * Must be called whenever the graph changes.
+ * @note Complexity: O(V^2 + E log E)
+*/
+void Manager::buildDerivedStructures()
+{
+	current.csr = CSRGraph(current.network);
+	buildFromCSR();
+}
+
+/**
+ * Builds the structures derived from the CSR graph: the trigonometry table 
+ * and spatial index if the vertexes have coordinates and, 
+ * if the graph is fully connected, the distance matrix.
+ * @note Complexity: O(V^2)
+*/
+void Manager::buildFromCSR()
+{
+	{
+		std::lock_guard<std::mutex> lock(mstMutex);
+		current.msts.clear();
+	}
+	current.geo = current.csr.hasCoordinates() ? GeoTable(current.csr) : GeoTable();
+	current.kdtree = current.csr.hasCoordinates() ? KDTree(current.csr) : KDTree();
+	current.fullyConnected = isGraphFullyConnected();
+	current.matrix = current.fullyConnected ? DistanceMatrix(current.csr) : DistanceMatrix();
+}
+
+/**
+ * Builds the pointer-based graph from the CSR graph, 
+ * if the dataset was loaded from a snapshot.
+ * Vertexes keep their order, edges are added in CSR order.
+ * @note Complexity: O(V + E)
+*/
+void Manager::buildNetwork()
+{
+	if (current.networkBuilt) return;
+	current.networkBuilt = true;
+
+	for (int v = 0; v < current.csr.getNumVertex(); v++)
+	{
+		Info info(current.csr.getLon(v), current.csr.getLat(v));
+		if (!current.labels.empty()) info.label = current.labels[v];
+		current.network.addVertex(current.csr.getId(v), info);
+	}
+
+	const std::vector<Vertex *> &vertexes = current.network.getVertexSet();
+	for (int v = 0; v < current.csr.getNumVertex(); v++)
+	{
+		for (size_t e = current.csr.edgeBegin(v); e < current.csr.edgeEnd(v); e++)
+			vertexes[v]->addEdge(vertexes[current.csr.getDest(e)], current.csr.getWeight(e));
+	}
+}
+
+/**
+ * Prepares the packed matrix with the haversine distance between every pair of vertexes,
+ * used by implicit completion. It is mapped from its file next to the nodes file 
+ * if it is up to date, otherwise computed by worker threads and saved.
+ * Graphs too large for the matrix keep computing distances on demand.
+ * @note Complexity: O(V^2), O(1) if mapped
+*/
+void Manager::loadPackedMatrix()
+{
+	int n = current.csr.getNumVertex();
+	if (current.coordinatesFile.empty() || current.geo.empty() || n > PACKED_MATRIX_MAX_VERTEXES) return;
+	if (current.packed.size() == n) return;
+
+	std::string path = packedMatrixPath();
+	if (useSnapshots && Snapshot::readMatrix(path, {current.coordinatesFile}, current.coordinatesRows, current.packed)
+		&& current.packed.size() == n) return;
+
+	current.packed = computePackedMatrix();
+	if (useSnapshots) Snapshot::writeMatrix(path, {current.coordinatesFile}, current.coordinatesRows, current.packed);
+}
+
+/**
+ * Computes the packed distance matrix of the current graph, a row per task.
+ * @note Complexity: O(V^2)
+*/
+PackedDistanceMatrix Manager::computePackedMatrix() const
+{
+	PackedDistanceMatrix matrix(current.csr.getNumVertex());
+	std::vector<std::vector<double>> buffers(getThreadCount());
+	parallelFor(0, matrix.size(), [&](size_t row, unsigned thread) {
+		matrix.fillRow(current.geo, row, buffers[thread]);
+	}, buffers.size(), 16);
+	return matrix;
+}
+
+/**
+ * @return Path of the packed distance matrix file of the current dataset,
+ * next to its nodes file.
+*/
+std::string Manager::packedMatrixPath() const
+{
+	std::ostringstream path;
+	path << current.coordinatesFile;
+	if (current.coordinatesRows != -1) path << "." << current.coordinatesRows;
+	path << ".dmat";
+	return path.str();
 }
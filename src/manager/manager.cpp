@@ -2,11 +2,15 @@
 
 /**
  * Default destructor.
- * Deletes the allocated memory in the graph.
+ * Stops the background loads and deletes the allocated memory in the graph.
  * @note Complexity: O(V + E) 
 */
 Manager::~Manager() {
-	network.resetGraph();
+	for (auto &job : prefetching)
+		job->cancel();
+	for (auto &job : prefetching)
+		job->wait();
+	current.network.resetGraph();
 }
 
 /**
@@ -14,53 +18,82 @@ Manager::~Manager() {
 */
 std::string Manager::getCurrentDatasetType() const
 {
-	std::ostringstream out;
-	switch (dType) {
-		case none:
-			return "None";
-		case toy_shipping:
-			return "Toy - Shipping";
-		case toy_stadiums:
-			return "Toy - Stadiums";
-		case toy_tourism:
-			return "Toy - Tourism";
-		case real_world:
-			out << "Real World - Graph " << option; 
-			return out.str();
-		case extra:
-			out << "Extra - " << option << " Nodes"; 
-			return out.str();
-		default:
-			return "None";
-	};
+	return datasetName(current.dType, current.option);
 }
 
 /**
  * @return Time taken to load the current dataset.
 */
-long Manager::getLoadTime() const {
-	return loadtime;
+double Manager::getLoadTime() const {
+	return current.loadtime;
+}
+
+/**
+ * @return Descriptions of the first rows skipped while loading the current dataset.
+*/
+const std::vector<std::string>& Manager::getLoadWarnings() const {
+	return current.loadWarnings;
+}
+
+/**
+ * @return Number of malformed rows skipped while loading the current dataset.
+*/
+size_t Manager::getSkippedRows() const {
+	return current.skippedRows;
 }
 
 /**
  * @return The graph for the current dataset.
+ * It is built first if the dataset was loaded from a snapshot.
 */
-Graph Manager::getNetwork() const {
-	return network;
+const Graph& Manager::getNetwork() {
+	buildNetwork();
+	return current.network;
+}
+
+/**
+ * @return The compressed sparse row view of the current graph.
+*/
+const CSRGraph& Manager::getCSR() const {
+	return current.csr;
+}
+
+/**
+ * @return The spatial index over the coordinates of the current graph,
+ * empty if its vertexes have no coordinates.
+*/
+const KDTree& Manager::getKDTree() const {
+	return current.kdtree;
 }
 
 /**
  * @return True if there is any dataset loaded.
 */
 bool Manager::isAnyDataSetLoaded() const {
-	return dType != none;
+	return current.dType != none;
 }
 
 /**
- * @return True if the graph is fully connected.
+ * @return True if the graph is fully connected, 
+ * either with real edges or through implicit completion.
 */
 bool Manager::isFullyConnected() const {
-	return fullyConnected;
+	return current.fullyConnected || current.implicitlyCompleted;
+}
+
+/**
+ * @return True if missing distances are being computed from the coordinates.
+*/
+bool Manager::isImplicitlyCompleted() const {
+	return current.implicitlyCompleted;
+}
+
+/**
+ * @return True if every vertex of the graph has coordinates, 
+ * which implicit completion requires.
+*/
+bool Manager::canImplicitlyComplete() const {
+	return current.csr.hasCoordinates();
 }
 
 /**
@@ -80,6 +113,35 @@ std::string Manager::getHeuristicAsString(HeuristicType type)
 			return "Other (T2.3)";
 		case real_world_2_4:
 			return "Real World (T2.4)";
+		case held_karp:
+			return "Held-Karp (exact)";
+		case branch_and_bound:
+			return "Branch and bound (exact)";
+		case lin_kernighan:
+			return "Lin-Kernighan (iterated)";
+		case multi_start:
+			return "Lin-Kernighan (multi-start)";
 	}
 	return "Unknown";
 }
+
+/**
+ * Tells if a heuristic stops at the deadline or cancellation of a SolveControl.
+ * The others are quick and always run to completion, as they have no tour before the end.
+ * @param type Heuristic type
+ * @return True for backtracking, Held-Karp, branch and bound and both Lin-Kernighan solvers.
+*/
+bool Manager::isInterruptible(HeuristicType type)
+{
+	switch (type)
+	{
+		case backtracking_2_1:
+		case held_karp:
+		case branch_and_bound:
+		case lin_kernighan:
+		case multi_start:
+			return true;
+		default:
+			return false;
+	}
+}
@@ -2,6 +2,16 @@
 #define MANAGER_H
 
 #include "../graph/graph.h"
+#include "../graph/csr.h"
+#include "../graph/distanceMatrix.h"
+#include "../graph/distanceCache.h"
+#include "../graph/geo.h"
+#include "../graph/kdtree.h"
+#include "../graph/packedDistanceMatrix.h"
+#include "dataset.h"
+#include "loadJob.h"
+#include "solveControl.h"
+#include "parallel.h"
 #include <string>
 #include <chrono>
 #include <fstream>
@@ -12,6 +22,10 @@
 #include <list>
 #include <stack>
 #include <unordered_set>
+#include <atomic>
+#include <mutex>
+
+class MappedFile;
 
 #ifdef __linux__
 # include <unistd.h>
@@ -33,18 +47,6 @@
 # define RESET "\r"
 #endif
 
-/**
- * Dataset types
-*/
-enum DatasetType {
-	none,
-	toy_shipping,
-	toy_stadiums,
-	toy_tourism,
-	real_world,
-	extra
-};
-
 /**
  * Identifies the heuristic for the 
  * Travelling Salesman Problem "solution".
@@ -53,7 +55,19 @@ enum HeuristicType {
 	backtracking_2_1,
 	triangular_approximation_2_2,
 	other_2_3,
-	real_world_2_4
+	real_world_2_4,
+	held_karp,
+	branch_and_bound,
+	lin_kernighan,
+	multi_start
+};
+
+/**
+ * Algorithms that build the minimum spanning trees of the network.
+*/
+enum MSTAlgorithm {
+	prim_mst,
+	boruvka_mst
 };
 
 /**
@@ -74,21 +88,74 @@ struct ReturnDataTSP {
 	
 	/** Total distance of the path. */
 	double totalDistance;
+
+	/** Number of search nodes explored, for the exact solvers that search a tree. */
+	size_t exploredNodes = 0;
+
+	/** Length of the tour before the local search, or -1 if it was not improved. */
+	double initialDistance = -1;
+
+	/** Number of improving moves applied by the local search. */
+	size_t improvingMoves = 0;
+
+	/** Time taken by the local search. */
+	double improvementTime = 0;
+
+	/** Time since the start and length of the best tour, each time it improved. */
+	std::vector<std::pair<double, double>> convergence = {};
+
+	/** Tours built and improved per second by each thread, for the multi-start solver. */
+	std::vector<double> startsPerSecond = {};
+
+	/** True if the run was stopped by its deadline or cancelled, so the tour is the best one so far. */
+	bool interrupted = false;
+
+	/** Time since the start when the returned tour was found, or -1 if there is none. */
+	double lastImprovement = -1;
+};
+
+/**
+ * Represents a single timed operation of the performance benchmarks.
+*/
+struct BenchmarkEntry {
+	/** Name of the operation. */
+	std::string name;
+
+	/** Time taken by the reference implementation, or -1 if there is none. */
+	double baseline;
+
+	/** Time taken by the optimized implementation. */
+	double optimized;
 };
 
 /**
  * Contains the methods to load the datasets into a graph 
  * and operate over it in order to (try to) generate 
- * the best path passing in all its vertexes (TSP) 
+ * the best path passing in all its vertexes (TSP).
+ * The selected dataset is kept in current,
+ * the others stay resident in the dataset cache.
 */
 class Manager {
 	private:
-		DatasetType dType = none;
-		int option = -1;
-		long loadtime = -1;
+		/** Largest graph whose implicit distances are kept in a packed matrix (800 MB). */
+		static const int PACKED_MATRIX_MAX_VERTEXES = 20000;
+
+		/** Maximum number of skipped rows described in the load warnings. */
+		static const size_t MAX_LOAD_WARNINGS = 20;
 
-		Graph network;
-		bool fullyConnected = true;
+		/** Selected dataset, moved in from the loaders and the cache as a whole. */
+		Dataset current;
+
+		bool useSnapshots = true;
+		DatasetCache cache;
+		mutable std::mutex mstMutex;
+		MSTAlgorithm mstAlgorithm = prim_mst;
+		unsigned mstThreads = 0;
+		unsigned multiStartThreads = 0;
+
+		/** Job this manager loads for, when it is the worker of a background load. */
+		LoadJob *loadJob = nullptr;
+		std::vector<std::shared_ptr<LoadJob>> prefetching;
 
 		// Loaders
 
@@ -98,48 +165,120 @@ class Manager {
 
 		void loadBig(std::string nodes, std::string edges, bool skipFirstRow, 
 			bool assumeBidirectional, long rowCount);
+		void buildDerivedStructures();
+		void buildFromCSR();
+		void buildNetwork();
+		void loadPackedMatrix();
+		PackedDistanceMatrix computePackedMatrix() const;
+		std::string packedMatrixPath() const;
+		bool readSnapshot(const std::string &path, const std::vector<std::string> &sources, 
+			int64_t params);
+		void writeSnapshot(const std::string &path, const std::vector<std::string> &sources, 
+			int64_t params);
+		void addLoadWarning(const std::string &fileName, size_t line);
+		bool openDatasetFile(MappedFile &file, const std::string &fileName);
+		bool loadCancelled() const;
+		void reportProgress(size_t bytes, size_t vertexes, size_t edges);
+		void collectPrefetched(DatasetType type, int option);
+		void adopt(Dataset &&dataset);
 
 		// Heuristics
 
-		ReturnDataTSP backtrackingHeuristic();
-		void backtrack(Graph* g, Vertex* v, std::vector<int>& currentPath, double& currentDistance, double* bestDistance, std::vector<int>* bestPath);
+		ReturnDataTSP backtrackingHeuristic(SolveControl &control) const;
+		void backtrack(const CSRGraph &g, int v, int start, std::vector<bool> &visited,
+			std::vector<int>& currentPath, double& currentDistance, double* bestDistance, std::vector<int>* bestPath,
+			SolveControl &control, size_t &steps) const;
 		
-		ReturnDataTSP triangularApproximationHeuristic();
-		Graph PrimMST(Graph &g, Vertex *base);
-		void trianApproxDfs(Vertex *vtx, Vertex *last, std::vector<int> &stops, 
-			std::vector<double> &distances, double *total);
+		ReturnDataTSP triangularApproximationHeuristic() const;
+		SpanningTree PrimMST(const CSRGraph &g, int base) const;
+		SpanningTree PrimMSTComplete(int base) const;
+		SpanningTree PrimParents(const CSRGraph &g, int base, bool dense) const;
+		SpanningTree PrimParentsComplete(int base) const;
+		template <typename Rows>
+		SpanningTree PrimDense(int n, int base, Rows rows) const;
+		SpanningTree PrimHeap(const CSRGraph &g, int base) const;
+		SpanningTree BoruvkaMST(unsigned threads) const;
+		std::shared_ptr<const SpanningTree> networkMST(int base) const;
+
+		ReturnDataTSP otherHeuristic() const;
+		void createClusters(double maxDistance, std::vector<std::vector<int>>& clusters) const;
+		double triangularCluster(const CSRGraph& graph, int base, std::vector<int>& stops, std::vector<double>& distances) const;
+
+		ReturnDataTSP heldKarpHeuristic(SolveControl &control) const;
+		ReturnDataTSP branchAndBoundHeuristic(SolveControl &control) const;
+		double heldKarp(int start, std::vector<int> &order, SolveControl &control) const;
 
-		ReturnDataTSP otherHeuristic();
-		void createClusters(Graph& g, double distance, std::vector<std::vector<Vertex*>>& clusters);
-		double triangularCluster(Graph& graph, Vertex* base, std::vector<int>& stops, std::vector<double>& distances);
+		ReturnDataTSP realWorldHeuristic(int base) const;
+		std::vector<CSREdge> perfectMatching(const SpanningTree &mst) const;
+		std::vector<int> eulerPath(const CSRGraph &g, int base) const;
+		std::vector<int> hamilton(const CSRGraph &g, std::vector<int> &eulerStops) const;
+		bool invalidPath(std::vector<int> &stops, std::vector<double> &dists, double *totalDist) const;
 
-		ReturnDataTSP realWorldHeuristic(Vertex *base);
-		std::vector<Edge *> perfectMatching(Graph &mst);
-		std::vector<Vertex *> eulerPath(Vertex *base);
-		std::vector<int> hamilton(std::vector<Vertex *> &eulerStops);
-		bool invalidPath(Graph &g, std::vector<int> &stops, std::vector<double> &dists, double *totalDist);
+		bool hasSymmetricDistances() const;
+		std::vector<int> alphaCandidates(int k) const;
+		ReturnDataTSP linKernighanHeuristic(SolveControl &control) const;
+		ReturnDataTSP iteratedLinKernighan(double timeLimit, size_t maxKicks, SolveControl &control) const;
+		ReturnDataTSP multiStartHeuristic(SolveControl &control) const;
+		ReturnDataTSP multiStartLinKernighan(unsigned threads, double timeLimit, SolveControl &control) const;
+		ReturnDataTSP tourOf(const std::vector<int> &order, double processingTime) const;
 
 	public:
+		/** Largest amount of memory the Held-Karp solver may use (4 GB). */
+		static const size_t HELD_KARP_MAX_MEMORY = (size_t)4 << 30;
+
 		~Manager();
 
 		std::string getCurrentDatasetType() const;
 		static std::string getHeuristicAsString(HeuristicType type);
+		static bool isInterruptible(HeuristicType type);
 		bool isAnyDataSetLoaded() const;
 		bool isFullyConnected() const;
-		long getLoadTime() const;
-		Graph getNetwork() const;
+		bool isImplicitlyCompleted() const;
+		bool canImplicitlyComplete() const;
+		double getLoadTime() const;
+		const std::vector<std::string>& getLoadWarnings() const;
+		size_t getSkippedRows() const;
+		const Graph& getNetwork();
+		const CSRGraph& getCSR() const;
+		const KDTree& getKDTree() const;
 
 		void loadDataset(DatasetType type, int option = -1);
-		ReturnDataTSP tspCaller(HeuristicType type, Vertex *base);
+		std::shared_ptr<LoadJob> startLoad(DatasetType type, int option = -1);
+		bool finishLoad(const std::shared_ptr<LoadJob> &job);
+		void prefetch(DatasetType type, int option = -1);
+		static bool nextDataset(DatasetType &type, int &option);
+		static std::vector<std::string> datasetFiles(DatasetType type, int option);
+		void setCacheBudget(size_t bytes);
+		const DatasetCache& getCache() const;
+		ReturnDataTSP tspCaller(HeuristicType type, int base = -1) const;
+		ReturnDataTSP tspCaller(HeuristicType type, int base, SolveControl &control) const;
+		std::vector<ReturnDataTSP> tspCallerParallel(const std::vector<HeuristicType> &types, 
+			int base) const;
+		size_t getHeldKarpMemory() const;
+		void setMSTAlgorithm(MSTAlgorithm algorithm, unsigned threads = 0);
+		MSTAlgorithm getMSTAlgorithm() const;
+		void setMultiStartThreads(unsigned threads);
+		unsigned getMultiStartThreads() const;
+		ReturnDataTSP improveTour(const ReturnDataTSP &tour, double timeLimit = 1.0,
+			size_t maxMoves = std::numeric_limits<size_t>::max()) const;
 
 		// HeuristicUtils
 
-		static double haversineDistance(Info pos1, Info pos2);
+		static double haversineDistance(const Info &pos1, const Info &pos2);
 		static double haversineDistance(double lat1, double lon1,
 			double lat2, double lon2);
 		static double to_radians(double num);
+		double distance(int orig, int dest) const;
+		void distanceRow(int orig, std::vector<double> &out) const;
+		std::vector<int> candidateLists(int k) const;
 		bool isGraphFullyConnected();
 		void fullyConnectGraph();
+		void implicitlyCompleteGraph();
+
+		// Benchmarks
+
+		std::vector<BenchmarkEntry> runBenchmarks();
+		std::vector<BenchmarkEntry> runLoadBenchmarks();
 };
 
 #endif
\ No newline at end of file
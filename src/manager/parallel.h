@@ -0,0 +1,58 @@
+#ifndef PARALLEL_H
+#define PARALLEL_H
+
+#include <thread>
+#include <atomic>
+#include <vector>
+#include <algorithm>
+
+/**
+ * @return Number of worker threads to use by default, 
+ * one per hardware thread.
+*/
+inline unsigned getThreadCount()
+{
+	unsigned count = std::thread::hardware_concurrency();
+	return count == 0 ? 1 : count;
+}
+
+/**
+ * Runs a function over every index of a range, split across worker threads.
+ * Indexes are handed out dynamically in chunks of (grain), 
+ * so uneven iterations are balanced between threads.
+ * The calling thread works as one of the workers.
+ * @param begin First index.
+ * @param end One past the last index.
+ * @param function Called as function(index, thread), thread being in [0, threads).
+ * @param threads Number of threads, 0 meaning getThreadCount().
+ * @param grain Number of consecutive indexes taken at a time.
+*/
+template <typename Function>
+void parallelFor(size_t begin, size_t end, Function function, 
+	unsigned threads = 0, size_t grain = 1)
+{
+	if (threads == 0) threads = getThreadCount();
+	if (grain == 0) grain = 1;
+	threads = (unsigned)std::max<size_t>(1, std::min<size_t>(threads, (end - begin + grain - 1) / grain));
+
+	std::atomic<size_t> next(begin);
+	auto worker = [&](unsigned thread) {
+		while (true)
+		{
+			size_t first = next.fetch_add(grain);
+			if (first >= end) break;
+			size_t last = std::min(end, first + grain);
+			for (size_t i = first; i < last; i++)
+				function(i, thread);
+		}
+	};
+
+	std::vector<std::thread> workers;
+	for (unsigned t = 1; t < threads; t++)
+		workers.emplace_back(worker, t);
+	worker(0);
+	for (auto &thr : workers)
+		thr.join();
+}
+
+#endif
@@ -0,0 +1,270 @@
+#include "snapshot.h"
+#include "csv.h"
+#include <filesystem>
+#include <fstream>
+#include <cstring>
+#include <limits>
+
+static_assert(sizeof(size_t) == sizeof(uint64_t), "snapshots store offsets as 64-bit values");
+
+static const char SNAPSHOT_MAGIC[8] = {'T', 'S', 'P', 'S', 'N', 'A', 'P', '\0'};
+static const char MATRIX_MAGIC[8] = {'T', 'S', 'P', 'D', 'M', 'A', 'T', '\0'};
+
+/**
+ * Reads the size and modification time of each source file.
+ * @return False if a file does not exist.
+*/
+bool Snapshot::stamp(const std::vector<std::string> &sources, SourceStamp *stamps)
+{
+	if (sources.size() > MAX_SOURCES) return false;
+	for (int i = 0; i < MAX_SOURCES; i++)
+		stamps[i] = {0, 0};
+
+	std::error_code error;
+	for (size_t i = 0; i < sources.size(); i++)
+	{
+		stamps[i].size = std::filesystem::file_size(sources[i], error);
+		if (error) return false;
+		stamps[i].modified = std::filesystem::last_write_time(sources[i], error)
+			.time_since_epoch().count();
+		if (error) return false;
+	}
+	return true;
+}
+
+/**
+ * Maps a file and checks its header against the current sources and parameters.
+ * @param magic Expected kind of file.
+ * @param file Set to the mapped file.
+ * @param header Set to the header of the file.
+ * @return True if the file exists and is up to date.
+*/
+bool Snapshot::openHeader(const std::string &path, const std::vector<std::string> &sources,
+	int64_t params, const char *magic, std::shared_ptr<MappedFile> &file, Header &header)
+{
+	SourceStamp stamps[MAX_SOURCES];
+	if (!stamp(sources, stamps)) return false;
+
+	file = std::make_shared<MappedFile>(path);
+	if (!file->isOpen() || file->size() < sizeof(Header)) return false;
+
+	memcpy(&header, file->begin(), sizeof(header));
+	if (memcmp(header.magic, magic, sizeof(header.magic)) != 0) return false;
+	if (header.version != VERSION || header.params != params) return false;
+	if (header.fileSize != file->size()) return false;
+	for (int i = 0; i < MAX_SOURCES; i++)
+	{
+		if (header.sources[i].size != stamps[i].size 
+			|| header.sources[i].modified != stamps[i].modified) return false;
+	}
+	return true;
+}
+
+/**
+ * Computes where each array is in the file. Arrays start at multiples of 8 bytes.
+*/
+Snapshot::Layout Snapshot::layout(uint64_t vertexCount, uint64_t edgeCount, uint64_t labelBytes)
+{
+	auto align = [](size_t offset) { return (offset + 7) & ~(size_t)7; };
+	Layout out;
+	out.ids = align(sizeof(Header));
+	out.offsets = align(out.ids + vertexCount * sizeof(int));
+	out.neighbors = align(out.offsets + (vertexCount + 1) * sizeof(size_t));
+	out.weights = align(out.neighbors + edgeCount * sizeof(int));
+	out.lats = out.weights + edgeCount * sizeof(double);
+	out.lons = out.lats + vertexCount * sizeof(double);
+	out.labelOffsets = out.lons + vertexCount * sizeof(double);
+	out.labels = out.labelOffsets + (vertexCount + 1) * sizeof(uint64_t);
+	out.end = out.labels + labelBytes;
+	return out;
+}
+
+/**
+ * Writes the snapshot of a loaded dataset.
+ * The file is written under a temporary name and then renamed,
+ * so that other processes never see a partial snapshot.
+ * @param path Path of the snapshot.
+ * @param sources Files the dataset was loaded from.
+ * @param params Loader parameters, stored to be compared on read.
+ * @param graph Loaded graph.
+ * @param labels Label of each vertex, by dense index. May be empty if no vertex has one.
+ * @return True if the snapshot was written.
+ * @note Complexity: O(V + E)
+*/
+bool Snapshot::write(const std::string &path, const std::vector<std::string> &sources,
+	int64_t params, const CSRGraph &graph, const std::vector<std::string> &labels)
+{
+	Header header;
+	memset(&header, 0, sizeof(header));
+	if (!stamp(sources, header.sources)) return false;
+
+	size_t n = graph.getNumVertex();
+	std::vector<uint64_t> labelOffsets(n + 1, 0);
+	for (size_t i = 0; i < n; i++)
+		labelOffsets[i + 1] = labelOffsets[i] + (labels.empty() ? 0 : labels[i].size());
+
+	memcpy(header.magic, SNAPSHOT_MAGIC, sizeof(header.magic));
+	header.version = VERSION;
+	header.coordinates = graph.hasCoordinates();
+	header.params = params;
+	header.vertexCount = n;
+	header.edgeCount = graph.getNumEdges();
+	header.labelBytes = labelOffsets[n];
+	Layout parts = layout(header.vertexCount, header.edgeCount, header.labelBytes);
+	header.fileSize = parts.end;
+
+	std::string temporary = path + ".tmp";
+	std::ofstream file(temporary, std::ios::binary | std::ios::trunc);
+	if (!file.is_open()) return false;
+
+	auto put = [&](size_t offset, const void *data, size_t bytes) {
+		static const char padding[8] = {};
+		file.write(padding, offset - (size_t)file.tellp());
+		if (bytes > 0) file.write(static_cast<const char *>(data), bytes);
+	};
+	file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+	put(parts.ids, graph.getIds().data(), n * sizeof(int));
+	put(parts.offsets, graph.getOffsets(), (n + 1) * sizeof(size_t));
+	put(parts.neighbors, graph.getNeighbors(), header.edgeCount * sizeof(int));
+	put(parts.weights, graph.getWeights(), header.edgeCount * sizeof(double));
+	put(parts.lats, graph.getLats(), n * sizeof(double));
+	put(parts.lons, graph.getLons(), n * sizeof(double));
+	put(parts.labelOffsets, labelOffsets.data(), (n + 1) * sizeof(uint64_t));
+	file.seekp(parts.labels);
+	for (size_t i = 0; i < n && !labels.empty(); i++)
+		file.write(labels[i].data(), labels[i].size());
+	return commit(file, temporary, path);
+}
+
+/**
+ * Closes a file written under a temporary name and renames it to its final path.
+ * @return True if the file was completely written and renamed.
+*/
+bool Snapshot::commit(std::ofstream &file, const std::string &temporary, const std::string &path)
+{
+	file.close();
+
+	std::error_code error;
+	if (!file) 
+	{
+		std::filesystem::remove(temporary, error);
+		return false;
+	}
+	std::filesystem::rename(temporary, path, error);
+	return !error;
+}
+
+/**
+ * Maps a snapshot, if it exists and is up to date with its sources.
+ * @param path Path of the snapshot.
+ * @param sources Files the dataset would be loaded from.
+ * @param params Loader parameters, which must match the stored ones.
+ * @param graph Set to a view of the mapped arrays, which stay mapped while it is in use.
+ * @param labels Filled with the label of each vertex, or left empty if no vertex has one.
+ * @return True if the snapshot was read. Snapshots whose arrays do not describe a graph,
+ * even of the right size, are not read.
+ * @note Complexity: O(V + E)
+*/
+bool Snapshot::read(const std::string &path, const std::vector<std::string> &sources,
+	int64_t params, CSRGraph &graph, std::vector<std::string> &labels)
+{
+	std::shared_ptr<MappedFile> file;
+	Header header;
+	if (!openHeader(path, sources, params, SNAPSHOT_MAGIC, file, header)) return false;
+
+	if (header.vertexCount > (uint64_t)std::numeric_limits<int>::max()) return false;
+	Layout parts = layout(header.vertexCount, header.edgeCount, header.labelBytes);
+	if (parts.end != file->size()) return false;
+
+	// The graph and the labels are views of the file, so a stale or corrupt one
+	// must not send them out of their arrays
+	const char *base = file->begin();
+	int n = header.vertexCount;
+	const size_t *offsets = reinterpret_cast<const size_t *>(base + parts.offsets);
+	const int *neighbors = reinterpret_cast<const int *>(base + parts.neighbors);
+	const uint64_t *labelOffsets = reinterpret_cast<const uint64_t *>(base + parts.labelOffsets);
+	if (offsets[0] != 0 || offsets[n] != header.edgeCount) return false;
+	for (int i = 0; i < n; i++)
+		if (offsets[i] > offsets[i + 1]) return false;
+	for (size_t e = 0; e < header.edgeCount; e++)
+		if (neighbors[e] < 0 || neighbors[e] >= n) return false;
+	if (header.labelBytes != 0)
+	{
+		if (labelOffsets[0] != 0 || labelOffsets[n] > header.labelBytes) return false;
+		for (int i = 0; i < n; i++)
+			if (labelOffsets[i] > labelOffsets[i + 1]) return false;
+	}
+
+	graph = CSRGraph::view(file, n, header.edgeCount,
+		reinterpret_cast<const int *>(base + parts.ids),
+		offsets,
+		neighbors,
+		reinterpret_cast<const double *>(base + parts.weights),
+		reinterpret_cast<const double *>(base + parts.lats),
+		reinterpret_cast<const double *>(base + parts.lons),
+		header.coordinates != 0);
+
+	labels.clear();
+	if (header.labelBytes == 0) return true;
+
+	labels.reserve(n);
+	for (int i = 0; i < n; i++)
+		labels.emplace_back(base + parts.labels + labelOffsets[i], labelOffsets[i + 1] - labelOffsets[i]);
+	return true;
+}
+
+/**
+ * Writes a packed distance matrix.
+ * @param path Path of the matrix file.
+ * @param sources Files the coordinates were loaded from.
+ * @param params Loader parameters, stored to be compared on read.
+ * @param matrix Matrix to save.
+ * @return True if the file was written.
+ * @note Complexity: O(V^2)
+*/
+bool Snapshot::writeMatrix(const std::string &path, const std::vector<std::string> &sources,
+	int64_t params, const PackedDistanceMatrix &matrix)
+{
+	Header header;
+	memset(&header, 0, sizeof(header));
+	if (!stamp(sources, header.sources)) return false;
+
+	size_t values = PackedDistanceMatrix::pairCount(matrix.size());
+	memcpy(header.magic, MATRIX_MAGIC, sizeof(header.magic));
+	header.version = VERSION;
+	header.coordinates = 1;
+	header.params = params;
+	header.vertexCount = matrix.size();
+	header.fileSize = sizeof(Header) + values * sizeof(float);
+
+	std::string temporary = path + ".tmp";
+	std::ofstream file(temporary, std::ios::binary | std::ios::trunc);
+	if (!file.is_open()) return false;
+
+	file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+	file.write(reinterpret_cast<const char *>(matrix.data()), values * sizeof(float));
+	return commit(file, temporary, path);
+}
+
+/**
+ * Maps a packed distance matrix, if it exists and is up to date with its sources.
+ * @param path Path of the matrix file.
+ * @param sources Files the coordinates are loaded from.
+ * @param params Loader parameters, which must match the stored ones.
+ * @param matrix Set to a view of the mapped values.
+ * @return True if the matrix was read.
+ * @note Complexity: O(1)
+*/
+bool Snapshot::readMatrix(const std::string &path, const std::vector<std::string> &sources,
+	int64_t params, PackedDistanceMatrix &matrix)
+{
+	std::shared_ptr<MappedFile> file;
+	Header header;
+	if (!openHeader(path, sources, params, MATRIX_MAGIC, file, header)) return false;
+	if (header.fileSize != sizeof(Header) 
+		+ PackedDistanceMatrix::pairCount(header.vertexCount) * sizeof(float)) return false;
+
+	matrix = PackedDistanceMatrix::view(file, header.vertexCount,
+		reinterpret_cast<const float *>(file->begin() + sizeof(Header)));
+	return true;
+}
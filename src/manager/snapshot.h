@@ -0,0 +1,78 @@
+#ifndef SNAPSHOT_H
+#define SNAPSHOT_H
+
+#include "../graph/csr.h"
+#include "../graph/packedDistanceMatrix.h"
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <memory>
+#include <fstream>
+
+class MappedFile;
+
+/**
+ * Versioned binary image of a loaded dataset: vertex ids, coordinates, labels
+ * and the CSR adjacency with its weights.
+ * Snapshots are read by memory-mapping the file, the CSR graph being a view
+ * of the mapped arrays, so processes using the same dataset share its pages.
+ * Packed distance matrixes are saved and mapped the same way, in their own files.
+ * A snapshot records the size and modification time of the files it was made from,
+ * plus the loader parameters, and is ignored if any of them changed.
+*/
+class Snapshot {
+public:
+	/** Format version. Snapshots with another version are ignored. */
+	static const uint32_t VERSION = 1;
+
+	/** Maximum number of source files of a snapshot. */
+	static const int MAX_SOURCES = 2;
+
+	static bool write(const std::string &path, const std::vector<std::string> &sources,
+		int64_t params, const CSRGraph &graph, const std::vector<std::string> &labels);
+	static bool read(const std::string &path, const std::vector<std::string> &sources,
+		int64_t params, CSRGraph &graph, std::vector<std::string> &labels);
+
+	static bool writeMatrix(const std::string &path, const std::vector<std::string> &sources,
+		int64_t params, const PackedDistanceMatrix &matrix);
+	static bool readMatrix(const std::string &path, const std::vector<std::string> &sources,
+		int64_t params, PackedDistanceMatrix &matrix);
+
+private:
+	struct SourceStamp {
+		uint64_t size;
+		int64_t modified;
+	};
+
+	struct Header {
+		char magic[8];
+		uint32_t version;
+		uint32_t coordinates;
+		SourceStamp sources[MAX_SOURCES];
+		int64_t params;
+		uint64_t vertexCount;
+		uint64_t edgeCount;
+		uint64_t labelBytes;
+		uint64_t fileSize;
+	};
+
+	struct Layout {
+		size_t ids;
+		size_t offsets;
+		size_t neighbors;
+		size_t weights;
+		size_t lats;
+		size_t lons;
+		size_t labelOffsets;
+		size_t labels;
+		size_t end;
+	};
+
+	static bool stamp(const std::vector<std::string> &sources, SourceStamp *stamps);
+	static bool openHeader(const std::string &path, const std::vector<std::string> &sources,
+		int64_t params, const char *magic, std::shared_ptr<MappedFile> &file, Header &header);
+	static bool commit(std::ofstream &file, const std::string &temporary, const std::string &path);
+	static Layout layout(uint64_t vertexCount, uint64_t edgeCount, uint64_t labelBytes);
+};
+
+#endif
@@ -0,0 +1,118 @@
+#ifndef SOLVE_CONTROL_H
+#define SOLVE_CONTROL_H
+
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <limits>
+#include <mutex>
+
+struct ReturnDataTSP;
+
+/**
+ * Limits and notifications of a heuristic run by Manager::tspCaller, for anytime solving:
+ * the run stops at the deadline or once cancelled, from any thread, and returns
+ * the best tour found so far. Each time the run finds a shorter tour, the callback
+ * gets it, possibly from one of the threads of the heuristic, but never from two at once.
+*/
+class SolveControl {
+public:
+	using Clock = std::chrono::high_resolution_clock;
+
+	SolveControl() = default;
+
+	/** Stops the run at a point in time. */
+	void setDeadline(Clock::time_point time) { deadline = time; }
+
+	/** Stops the run a number of seconds from now. */
+	void setTimeLimit(double seconds)
+	{
+		deadline = Clock::now() + std::chrono::duration_cast<Clock::duration>(
+			std::chrono::duration<double>(seconds));
+	}
+
+	Clock::time_point getDeadline() const { return deadline; }
+
+	/** Sets the function called with each shorter tour found. */
+	void setCallback(std::function<void(const ReturnDataTSP&)> function) { callback = function; }
+
+	/** Asks the run to stop, from any thread. */
+	void cancel() { cancelled = true; stopped = true; }
+	bool isCancelled() const { return cancelled; }
+
+	/** @return True once the run was asked to stop or went past the deadline. */
+	bool isStopped() const { return stopped.load(std::memory_order_relaxed); }
+
+	/**
+	 * Compares the time with the deadline. Reading the clock is slower than isStopped,
+	 * so searches call this every so many steps and isStopped in between.
+	 * @return True if the run must stop.
+	*/
+	bool check()
+	{
+		if (!stopped.load(std::memory_order_relaxed) && Clock::now() >= deadline) stopped = true;
+		return isStopped();
+	}
+
+	/** Starts the clock of a run, forgetting the tours of the previous one. */
+	void begin()
+	{
+		start = Clock::now();
+		best = std::numeric_limits<double>::max();
+		lastImprovement = -1;
+		shown = std::numeric_limits<double>::max();
+		stopped = cancelled.load();
+	}
+
+	/** @return Seconds since the run began. */
+	double elapsed() const { return std::chrono::duration<double>(Clock::now() - start).count(); }
+
+	/** @return Seconds from the beginning of the run until the best tour was found, -1 if none was. */
+	double getLastImprovement() const
+	{
+		std::lock_guard<std::mutex> guard(lock);
+		return lastImprovement;
+	}
+
+	/**
+	 * Records a tour found by the run, if it is shorter than every one before.
+	 * The tour is built and passed to the callback after the lock of the lengths is released,
+	 * so the other threads can keep reporting while it runs. A tour that is no longer
+	 * the shortest by the time the callback is free is not passed to it.
+	 * @param length Length of the tour.
+	 * @param build Makes the tour for the callback, only called if there is one to call.
+	*/
+	template <typename Build>
+	void report(double length, Build build)
+	{
+		{
+			std::lock_guard<std::mutex> guard(lock);
+			if (length >= best) return;
+			best = length;
+			lastImprovement = elapsed();
+		}
+		if (!callback) return;
+		auto tour = build();
+		std::lock_guard<std::mutex> guard(callbackLock);
+		if (length >= shown) return;
+		shown = length;
+		callback(tour);
+	}
+
+private:
+	Clock::time_point deadline = Clock::time_point::max();
+	Clock::time_point start = Clock::now();
+	std::function<void(const ReturnDataTSP&)> callback;
+	std::atomic<bool> cancelled{false};
+	std::atomic<bool> stopped{false};
+
+	mutable std::mutex lock;
+	double best = std::numeric_limits<double>::max();
+	double lastImprovement = -1;
+
+	/** Held while the callback runs, with the length of the last tour passed to it. */
+	std::mutex callbackLock;
+	double shown = std::numeric_limits<double>::max();
+};
+
+#endif
@@ -1,25 +1,88 @@
 #include "manager.h"
 
 /**
- * Calls the appropriate heuristic from within the manager.
+ * Calls the appropriate heuristic from within the manager, until it finishes.
  * @return Structure with time taken, stops, distances between stops 
  * and total distance travelled.
  * @param type Type of heuristic
- * @param base Only needed for 4th heuristic, defines the base vertex.
+ * @param base Only needed for 4th heuristic, id of the base vertex.
 */
-ReturnDataTSP Manager::tspCaller(HeuristicType type, Vertex *base = nullptr)
+ReturnDataTSP Manager::tspCaller(HeuristicType type, int base) const
 {
+	SolveControl control;
+	return tspCaller(type, base, control);
+}
+
+/**
+ * Calls the appropriate heuristic from within the manager, as an anytime run:
+ * it stops at the deadline of the control or once it is cancelled, and returns the best
+ * tour found so far, marked as interrupted. Each shorter tour found is passed to the callback
+ * of the control as the run goes. The exact solvers and Lin-Kernighan look at the control
+ * every few thousand steps, the other heuristics are quick and always finish, ignoring it
+ * (see isInterruptible).
+ * If the run is stopped before finding any tour, as Held-Karp always is,
+ * the result has no stops and is marked as interrupted.
+ * @param type Type of heuristic
+ * @param base Only needed for 4th heuristic, id of the base vertex.
+ * @param control Deadline, cancellation and callback of the run.
+ * @return Structure with time taken, stops, distances between stops, total distance
+ * travelled, whether the run was interrupted and when its tour was found.
+*/
+ReturnDataTSP Manager::tspCaller(HeuristicType type, int base, SolveControl &control) const
+{
+	control.begin();
+	ReturnDataTSP result = {-1, {}, {}, -1};
 	switch(type)
 	{
 		case backtracking_2_1:
-			return backtrackingHeuristic();
+			result = backtrackingHeuristic(control);
+			break;
 		case triangular_approximation_2_2:
-			return triangularApproximationHeuristic();
+			result = triangularApproximationHeuristic();
+			break;
 		case other_2_3:
-			return otherHeuristic();
+			result = otherHeuristic();
+			break;
 		case real_world_2_4:
-			return realWorldHeuristic(base);
+			result = realWorldHeuristic(base);
+			break;
+		case held_karp:
+			result = heldKarpHeuristic(control);
+			break;
+		case branch_and_bound:
+			result = branchAndBoundHeuristic(control);
+			break;
+		case lin_kernighan:
+			result = linKernighanHeuristic(control);
+			break;
+		case multi_start:
+			result = multiStartHeuristic(control);
+			break;
 	}
-	
-	return {-1, {}, {}, -1};
+
+	if (result.interrupted && result.stops.empty()) result.processingTime = control.elapsed();
+
+	// Heuristics that do not report their tours as they go only have the final one
+	if (control.getLastImprovement() == -1 && !result.stops.empty() && result.totalDistance >= 0)
+		control.report(result.totalDistance, [&]() { return result; });
+	result.lastImprovement = control.getLastImprovement();
+	return result;
+}
+
+/**
+ * Runs several heuristics at the same time, each in its own thread.
+ * The heuristics only read the loaded graph and keep their working state 
+ * in their own arrays, so they can share the same dataset.
+ * @param types Heuristics to run.
+ * @param base Only needed for 4th heuristic, id of the base vertex.
+ * @return Result of each heuristic, in the same order as (types).
+*/
+std::vector<ReturnDataTSP> Manager::tspCallerParallel(const std::vector<HeuristicType> &types, 
+	int base) const
+{
+	std::vector<ReturnDataTSP> results(types.size());
+	parallelFor(0, types.size(), [&](size_t i, unsigned) {
+		results[i] = tspCaller(types[i], base);
+	}, types.size());
+	return results;
 }
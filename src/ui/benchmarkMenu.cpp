@@ -0,0 +1,54 @@
+#include "ui.h"
+
+/**
+ * Hidden menu.
+ * Runs the performance benchmarks over the currently loaded dataset and shows their results.
+*/
+void UI::benchmarkMenu()
+{
+	CLEAR;
+	if (!manager.isAnyDataSetLoaded())
+	{
+		showMessage(
+			"NO DATASET WAS SELECTED",
+			"Select a dataset in the main menu with the 'c' command."
+		);
+		return;
+	}
+
+	std::cout << "Running benchmarks on " << manager.getCurrentDatasetType() << "...\n";
+	std::vector<BenchmarkEntry> entries = manager.runBenchmarks();
+	for (auto &entry : manager.runLoadBenchmarks())
+		entries.push_back(entry);
+
+	// The columns have their own precision, the one of the other menus is restored after them
+	std::ios_base::fmtflags flags = std::cout.flags();
+	std::streamsize precision = std::cout.precision();
+	CLEAR;
+	std::cout
+	<< "Benchmarks for " << manager.getCurrentDatasetType() << "\n"
+	<< "\n"
+	<< std::left << std::setw(36) << "Operation"
+	<< std::right << std::setw(14) << "Baseline (s)"
+	<< std::setw(14) << "Optimized (s)"
+	<< std::setw(10) << "Speedup" << "\n";
+
+	for (auto &entry : entries)
+	{
+		std::cout << std::left << std::setw(36) << entry.name << std::right << std::setw(14);
+		if (entry.baseline < 0) std::cout << "-";
+		else std::cout << std::setprecision(6) << std::fixed << entry.baseline;
+		std::cout << std::setw(14) << std::setprecision(6) << std::fixed << entry.optimized;
+		std::cout << std::setw(10);
+		if (entry.baseline < 0 || entry.optimized <= 0) std::cout << "-";
+		else std::cout << std::setprecision(1) << entry.baseline / entry.optimized << "x";
+		std::cout << "\n";
+	}
+	std::cout.flags(flags);
+	std::cout.precision(precision);
+
+	std::cout
+	<< "\n"
+	<< "CLICK ENTER TO CONTINUE...\n";
+	while (std::cin.get() != '\n') { }
+}
@@ -0,0 +1,62 @@
+#include "ui.h"
+
+/**
+ * Runs the heuristics at the same time on the currently loaded dataset
+ * and shows their results side by side.
+ * The exact solvers are only included for small graphs, as they are exponential.
+*/
+void UI::compareMenu()
+{
+	int base = getBaseVertex();
+	if (base == -1) return;
+
+	std::vector<HeuristicType> types;
+	if (manager.getCSR().getNumVertex() <= 12) types.push_back(backtracking_2_1);
+	if (manager.getCSR().getNumVertex() <= 20) types.push_back(held_karp);
+	if (manager.getCSR().getNumVertex() <= 30) types.push_back(branch_and_bound);
+	types.push_back(triangular_approximation_2_2);
+	types.push_back(other_2_3);
+	types.push_back(real_world_2_4);
+	types.push_back(lin_kernighan);
+
+	CLEAR;
+	std::cout << "Running " << types.size() << " heuristics...\n";
+	auto start = std::chrono::high_resolution_clock::now();
+	std::vector<ReturnDataTSP> results = manager.tspCallerParallel(types, base);
+	auto end = std::chrono::high_resolution_clock::now();
+
+	// The columns have their own precision, the one of the other menus is restored after them
+	std::ios_base::fmtflags flags = std::cout.flags();
+	std::streamsize precision = std::cout.precision();
+	CLEAR;
+	std::cout
+	<< "Heuristics for " << manager.getCurrentDatasetType() << "\n"
+	<< "\n"
+	<< std::left << std::setw(36) << "Heuristic"
+	<< std::right << std::setw(20) << "Distance (km)"
+	<< std::setw(14) << "Time (s)" << "\n";
+
+	for (size_t i = 0; i < types.size(); i++)
+	{
+		std::cout << std::left << std::setw(36) << Manager::getHeuristicAsString(types[i]) 
+			<< std::right << std::setw(20);
+		if (isTSPFailed(results[i]) || isTSPInvalid(results[i]))
+		{
+			std::cout << "No valid path" << std::setw(14) << "-" << "\n";
+			continue;
+		}
+		std::cout << std::setprecision(1) << std::fixed << results[i].totalDistance
+			<< std::setw(14) << std::setprecision(3) << results[i].processingTime << "\n";
+	}
+
+	std::cout
+	<< "\n"
+	<< "Total time: " << std::chrono::duration<double>(end - start).count() << "s\n";
+	std::cout.flags(flags);
+	std::cout.precision(precision);
+
+	std::cout
+	<< "\n"
+	<< "CLICK ENTER TO CONTINUE...\n";
+	while (std::cin.get() != '\n') { }
+}
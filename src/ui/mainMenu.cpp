@@ -20,6 +20,11 @@ void UI::mainMenu()
 		<< " [2] Triangular approximation\n"
 		<< " [3] Other\n"
 		<< " [4] Real World\n"
+		<< " [5] Compare heuristics\n"
+		<< " [6] Held-Karp (exact)\n"
+		<< " [7] Branch and bound (exact)\n"
+		<< " [8] Lin-Kernighan\n"
+		<< " [9] Lin-Kernighan (multi-start)\n"
 		<< "\n"
 		<< ">> Currently selected dataset: " << manager.getCurrentDatasetType();
 		
@@ -30,12 +35,28 @@ void UI::mainMenu()
 		{
 			std::cout << "\nWARNING: The graph is not fully connected.\n";
 		}
+
+		if (manager.isImplicitlyCompleted())
+		{
+			std::cout << "\nMissing edges are computed from the coordinates (implicit completion).\n";
+		}
+
+		if (timeLimit > 0)
+		{
+			std::cout << "\nHeuristics 1 and 6 to 9 stop after " << timeLimit << "s with their best tour so far.\n";
+		}
 		
 
 		std::cout
 		<< "\n"
 		<< "[C] Change Dataset\n"
 		<< (notFullyConnected ? "[F] Fully connect graph\n" : "")
+		<< (notFullyConnected && manager.canImplicitlyComplete() 
+			? "[I] Implicitly complete graph (no extra edges)\n" : "")
+		<< "[L] Set a time limit for the heuristics\n"
+		<< (manager.getMSTAlgorithm() == prim_mst 
+			? "[S] Spanning trees: Prim (switch to parallel Boruvka)\n" 
+			: "[S] Spanning trees: parallel Boruvka (switch to Prim)\n")
 		<< "\n"
 		<< "[Q] Exit\n"
 		<< "\n"
@@ -65,6 +86,30 @@ void UI::mainMenu()
 							"Select a dataset in the main menu with the 'c' command."
 						);
 					break;
+				case '6':
+				case '7':
+				case '8':
+				case '9':
+					if (manager.isAnyDataSetLoaded())
+						resultMenu(str[0] == '6' ? held_karp 
+							: str[0] == '7' ? branch_and_bound 
+							: str[0] == '8' ? lin_kernighan 
+							: multi_start);
+					else
+						showMessage(
+							"NO DATASET WAS SELECTED",
+							"Select a dataset in the main menu with the 'c' command."
+						);
+					break;
+				case '5':
+					if (manager.isAnyDataSetLoaded())
+						compareMenu();
+					else
+						showMessage(
+							"NO DATASET WAS SELECTED",
+							"Select a dataset in the main menu with the 'c' command."
+						);
+					break;
 				case 'c':
 				case 'C':
 					selectorMenu();
@@ -73,10 +118,27 @@ void UI::mainMenu()
 				case 'T':
 					testManager();
 					break;
+				case 'p':
+				case 'P':
+					benchmarkMenu();
+					break;
 				case 'f':
 				case 'F':
 					manager.fullyConnectGraph();
 					break;
+				case 'i':
+				case 'I':
+					if (notFullyConnected && manager.canImplicitlyComplete())
+						manager.implicitlyCompleteGraph();
+					break;
+				case 'l':
+				case 'L':
+					selectTimeLimit();
+					break;
+				case 's':
+				case 'S':
+					manager.setMSTAlgorithm(manager.getMSTAlgorithm() == prim_mst ? boruvka_mst : prim_mst);
+					break;
 			}
 		}
     }
@@ -92,7 +154,7 @@ void UI::testManager()
 	CLEAR;
 	std::string str;
 	
-	Graph network = manager.getNetwork();
+	const Graph &network = manager.getNetwork();
 	for (auto m : network.getVertexSet())
 	{
 		std::cout << m->getId() << " " << m->getInfo().toStr() 
@@ -12,8 +12,8 @@ bool UI::isTSPInvalid(ReturnDataTSP data)
 }
 
 /**
- * Checks if the return data from a heuristic failed,
- * but no message needs to be shown.
+ * Checks if a heuristic ran correctly,
+ * but was not able to find a valid path.
  * @param data Struct containing the data generated by the heuristic.
 */
 bool UI::isTSPFailed(ReturnDataTSP data)
@@ -24,9 +24,9 @@ bool UI::isTSPFailed(ReturnDataTSP data)
 /**
  * Selects a vertex from the currently loaded graph 
  * in order to be used in heuristic 4.4
- * @return Vertex selected using an id.
+ * @return Id of the vertex selected, or -1 if the user went back.
 */
-Vertex *UI::getBaseVertex()
+int UI::getBaseVertex()
 {
 	while (1)
 	{
@@ -40,7 +40,7 @@ Vertex *UI::getBaseVertex()
 		std::string str;
 		std::getline(std::cin, str);
 
-		if (str == "b" || str == "B") return nullptr;
+		if (str == "b" || str == "B") return -1;
 
 		if (str == "q" || str == "Q")
 		{
@@ -51,8 +51,7 @@ Vertex *UI::getBaseVertex()
 		try 
 		{
 			int id = std::stoi(str);
-			Vertex *ret = manager.getNetwork().findVertex(id);
-			if (ret != nullptr) return ret;
+			if (manager.getCSR().findIndex(id) != -1) return id;
 			showMessage("INVALID VERTEX", "Please input a valid id!");
 		}
 		catch (const std::exception& e)
@@ -60,7 +59,146 @@ Vertex *UI::getBaseVertex()
 			showMessage("COULD NOT CONVERT NUMBER", "Please input a valid number!");
 		}		
 	}
-	return nullptr;
+	return -1;
+}
+
+/**
+ * Shows how much memory the Held-Karp solver needs for the current graph
+ * and asks the user to confirm before it starts.
+ * @return True if the solver should run.
+*/
+bool UI::confirmHeldKarp()
+{
+	size_t memory = manager.getHeldKarpMemory();
+	int n = manager.getCSR().getNumVertex();
+	if (memory > Manager::HELD_KARP_MAX_MEMORY)
+	{
+		std::ostringstream body;
+		body << "Held-Karp needs memory exponential in the number of vertexes,\n"
+		<< "more than " << (Manager::HELD_KARP_MAX_MEMORY >> 30) << " GB for " << n << " vertexes.";
+		showMessage("GRAPH TOO LARGE", body.str());
+		return false;
+	}
+
+	while (1)
+	{
+		std::ostringstream size;
+		size << std::fixed << std::setprecision(1) << memory / (double)(1 << 20);
+
+		CLEAR;
+		std::cout 
+		<< "Held-Karp will use about " << size.str() << " MB for " << n << " vertexes.\n"
+		<< "\n"
+		<< "[Y] Run\t[B] Back\n"
+		<< "\n"
+        << "$> ";
+
+		std::string str;
+		std::getline(std::cin, str);
+
+		if (str == "y" || str == "Y") return true;
+		if (str == "b" || str == "B") return false;
+	}
+}
+
+/**
+ * Asks the user for the number of threads of the multi-start solver.
+ * @return False if the user went back.
+*/
+bool UI::selectThreads()
+{
+	while (1)
+	{
+		CLEAR;
+		std::cout 
+		<< "The multi-start solver runs on several threads for 2 seconds.\n"
+		<< "Please indicate the number of threads (Enter for " << getThreadCount() << "):\n"
+		<< "\n"
+		<< "$> ";
+
+		std::string str;
+		std::getline(std::cin, str);
+
+		if (str == "b" || str == "B") return false;
+
+		if (str == "q" || str == "Q")
+		{
+			CLEAR;
+			exit(0);
+		}
+
+		if (str.empty())
+		{
+			manager.setMultiStartThreads(0);
+			return true;
+		}
+
+		try 
+		{
+			int threads = std::stoi(str);
+			if (threads > 0)
+			{
+				manager.setMultiStartThreads(threads);
+				return true;
+			}
+			showMessage("INVALID NUMBER", "Please input a positive number!");
+		}
+		catch (const std::exception& e)
+		{
+			showMessage("COULD NOT CONVERT NUMBER", "Please input a valid number!");
+		}
+	}
+}
+
+/**
+ * Asks the user for the number of seconds after which the heuristics stop
+ * and return the best tour found so far.
+*/
+void UI::selectTimeLimit()
+{
+	while (1)
+	{
+		CLEAR;
+		std::cout 
+		<< "Heuristics stop after the time limit and return the best tour found so far.\n"
+		<< "It applies to backtracking, Held-Karp, branch and bound and Lin-Kernighan,\n"
+		<< "the other heuristics are quick and always finish.\n"
+		<< "Please indicate the time limit in seconds (Enter for none):\n"
+		<< "\n"
+		<< "$> ";
+
+		std::string str;
+		std::getline(std::cin, str);
+
+		if (str == "b" || str == "B") return;
+
+		if (str == "q" || str == "Q")
+		{
+			CLEAR;
+			exit(0);
+		}
+
+		if (str.empty())
+		{
+			timeLimit = 0;
+			return;
+		}
+
+		try 
+		{
+			double seconds = std::stod(str);
+			if (seconds > 0)
+			{
+				timeLimit = seconds;
+				return;
+			}
+			showMessage("INVALID NUMBER", "Please input a positive number!");
+		}
+		catch (const std::exception& e)
+		{
+			showMessage("COULD NOT CONVERT NUMBER", "Please input a valid number!");
+		}
+	}
 }
 
 /**
@@ -69,14 +207,45 @@ Vertex *UI::getBaseVertex()
 */
 void UI::resultMenu(HeuristicType type)
 {
-	Vertex *base = nullptr;
+	int base = -1;
 	if (type == HeuristicType::real_world_2_4) 
 	{
 		base = getBaseVertex();
-		if (base == nullptr) return;
+		if (base == -1) return;
+	}
+
+	if (type == HeuristicType::held_karp && !confirmHeldKarp()) return;
+	if (type == HeuristicType::multi_start && !selectThreads()) return;
+
+	// Shows each shorter tour as the heuristic finds it. The time limit only applies
+	// to the heuristics that can stop, the others always finish
+	SolveControl control;
+	if (timeLimit > 0 && Manager::isInterruptible(type)) control.setTimeLimit(timeLimit);
+	control.setCallback([](const ReturnDataTSP &tour) {
+		std::ostringstream line;
+		line << "Best tour so far: " << tour.totalDistance << "km, found after " 
+			<< tour.processingTime << "s\n";
+		std::cout << line.str() << std::flush;
+	});
+	ReturnDataTSP ret = manager.tspCaller(type, base, control);
+
+	if (ret.interrupted && ret.stops.empty())
+	{
+		std::ostringstream body;
+		body << "The heuristic was stopped at the time limit (" << timeLimit << "s)\n"
+		<< "before finding any tour.";
+		showMessage("NO TOUR FOUND", body.str());
+		return;
 	}
 
-	ReturnDataTSP ret = manager.tspCaller(type, base);
+	if (isTSPFailed(ret))
+	{
+		showMessage(
+			"NO AVAILABLE PATH",
+			"The algorithm was not able to find a valid path."
+		);
+		return;
+	}
 
 	if (isTSPInvalid(ret))
 	{
@@ -84,8 +253,6 @@ void UI::resultMenu(HeuristicType type)
 		return;
 	}
 
-	if (isTSPFailed(ret)) return;
-
 	size_t count = 0;
 	while (1)
 	{
@@ -110,9 +277,43 @@ void UI::resultMenu(HeuristicType type)
 		<< "\n" 
 		<< "Total Stops: " << ret.stops.size() - 2 << " (" << ret.stops.size() - 1 << " nodes visited)\n"
 		<< "Total Distance Travelled: " << ret.totalDistance << "km\n"
-		<< "Time taken to run the heuristic: " << ret.processingTime << "s\n"
+		<< "Time taken to run the heuristic: " << ret.processingTime << "s\n";
+		if (ret.interrupted) std::cout << "Stopped at the time limit, this is the best tour found so far.\n";
+		if (ret.lastImprovement != -1) std::cout << "Tour found after: " << ret.lastImprovement << "s\n";
+		if (ret.exploredNodes != 0) std::cout << "Search nodes explored: " << ret.exploredNodes << "\n";
+		if (ret.initialDistance != -1) std::cout << "Local search: " << ret.initialDistance << "km -> " 
+			<< ret.totalDistance << "km (" << ret.improvingMoves << " moves, " << ret.improvementTime << "s)\n";
+		if (!ret.convergence.empty())
+		{
+			// Best length reached within each power of ten of seconds
+			std::cout << "Best distance over time:";
+			for (double limit = 0.001; ; limit *= 10)
+			{
+				auto it = std::upper_bound(ret.convergence.begin(), ret.convergence.end(), 
+					std::make_pair(limit, INF));
+				std::ostringstream seconds;
+				seconds << limit;
+				if (it != ret.convergence.begin()) 
+					std::cout << " [" << seconds.str() << "s] " << std::prev(it)->second << "km";
+				if (limit >= ret.convergence.back().first) break;
+			}
+			std::cout << "\n";
+		}
+		if (!ret.startsPerSecond.empty())
+		{
+			double total = 0;
+			std::cout << "Starts per second:";
+			for (size_t t = 0; t < ret.startsPerSecond.size(); t++)
+			{
+				std::cout << " [" << t << "] " << ret.startsPerSecond[t];
+				total += ret.startsPerSecond[t];
+			}
+			std::cout << " (total " << total << ")\n";
+		}
+		std::cout
 		<< "\n"
 		<< "[S] - Push list down\t[W] - Push list up\n"
+		<< "[O] - Improve tour (2-opt / Or-opt)\n"
 		<< "[B] - Back \t\t[Q] - Exit\n"
 		<< "\n"
         << "$> ";
@@ -139,5 +340,24 @@ void UI::resultMenu(HeuristicType type)
 			count = count < 5 ? 0 : count - 5;
 			continue;
 		}
+
+		if (str == "o" || str == "O")
+		{
+			ReturnDataTSP improved = manager.improveTour(ret);
+			if (improved.initialDistance == -1)
+			{
+				showMessage("CANNOT IMPROVE", "The local search needs a tour through every vertex.");
+				continue;
+			}
+			// Several rounds add up to the length of the heuristic's own tour
+			if (ret.initialDistance != -1)
+			{
+				improved.initialDistance = ret.initialDistance;
+				improved.improvingMoves += ret.improvingMoves;
+				improved.improvementTime += ret.improvementTime;
+			}
+			ret = improved;
+			continue;
+		}
 	}
 }
@@ -29,9 +29,19 @@ void UI::selectorMenu()
 		<< " 1, 2, 3\n"
 		<< "\n"
 		<< ">> Currently selected dataset: " << manager.getCurrentDatasetType() << "\n"
+		<< ">> Kept in memory: ";
+		const DatasetCache &cache = manager.getCache();
+		std::vector<std::string> resident = cache.getResident();
+		for (size_t i = 0; i < resident.size(); i++)
+			std::cout << (i ? ", " : "") << resident[i];
+		if (resident.empty()) std::cout << "None";
+		std::cout
+		<< " (" << cache.getMemoryUsage() / (1 << 20) << " of " << cache.getBudget() / (1 << 20) << " MB)\n"
 		<< "\n"
 		<< "Select a dataset using the syntax:\n"
         << "<dataset id> <dataset option>\n"
+		<< "Change the memory kept for other datasets with:\n"
+		<< "M <megabytes>\n"
 		<< "\n"
 		<< "[B] Back\t[Q] Exit\n"
 		<< "\n"
@@ -48,6 +58,15 @@ void UI::selectorMenu()
 				return loaderScreen(extra, num);
 		}
 
+		if (str.size() >= 3 && (str[0] == 'm' || str[0] == 'M') && str[1] == ' ')
+		{
+			char *end;
+			unsigned long megabytes = strtoul(str.c_str() + 2, &end, 10);
+			if (*end == '\0' && end != str.c_str() + 2)
+				manager.setCacheBudget((size_t)megabytes << 20);
+			continue;
+		}
+
 		if (str == "1 1")
 			return loaderScreen(toy_shipping, -1);
 		if (str == "1 2")
@@ -72,35 +91,47 @@ void UI::selectorMenu()
 }
 
 /**
- * Function used in a secondary thread to show the time elapsed during load.
- * @param active Bool used to indicated if the load is still ongoing. The function returns when active is set to false.
+ * Shows a loading screen while the manager loads a dataset in the background,
+ * with the time elapsed and how much of the dataset was read.
+ * Once loaded, the next dataset of the list starts loading in the background.
+ * @param type Dataset type
+ * @param option Required by some types to identify a single dataset.
 */
-void thrLoadScreen(bool *active)
+void UI::loaderScreen(DatasetType type, int option)
 {
 	auto start = std::chrono::high_resolution_clock::now();
+	std::shared_ptr<LoadJob> job = manager.startLoad(type, option);
+	const LoadProgress &progress = job->getProgress();
 	CLEAR;
 	std::cout 
 	<< "Loading Dataset...\n";
-	while (*active)
+	do
 	{
 		auto now = std::chrono::high_resolution_clock::now();
 		auto elapsed = std::chrono::duration<double>(now - start).count();
-		std::cout << RESET << "Time elapsed: " << std::fixed << std::setprecision(1) << elapsed << "s";
-		PAUSE(100);
+		std::ostringstream line;
+		line << RESET << "Time elapsed: " << std::fixed << std::setprecision(1) << elapsed << "s";
+		if (progress.bytesTotal > 0)
+			line << " | Read " << progress.bytesParsed / (1 << 20) << " of " 
+			<< progress.bytesTotal / (1 << 20) << " MB";
+		line << " | " << progress.vertexes << " vertexes, " << progress.edges << " edges";
+		std::cout << line.str() << std::flush;
+		if (!job->isDone()) PAUSE(100);
+	} while (!job->isDone());
+
+	if (!manager.finishLoad(job))
+	{
+		if (!job->getError().empty()) showMessage("COULD NOT LOAD DATASET", job->getError() + "\n");
+		return;
 	}
+	if (Manager::nextDataset(type, option)) manager.prefetch(type, option);
 
-}
+	if (manager.getSkippedRows() == 0) return;
 
-/**
- * Shows a loading screen via a thread and calls the manager to load a dataset.
- * @param type Dataset type
- * @param option Required by some types to identify a single dataset.
-*/
-void UI::loaderScreen(DatasetType type, int option)
-{
-	bool active = true;
-	std::thread loader = std::thread(thrLoadScreen, &active);
-	manager.loadDataset(type, option);
-	active = false;
-	loader.join();
+	std::ostringstream body;
+	for (auto &warning : manager.getLoadWarnings())
+		body << warning << "\n";
+	if (manager.getSkippedRows() > manager.getLoadWarnings().size())
+		body << "... and " << manager.getSkippedRows() - manager.getLoadWarnings().size() << " more\n";
+	showMessage("SOME ROWS COULD NOT BE READ", body.str());
 }
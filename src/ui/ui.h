@@ -12,19 +12,27 @@
 class UI {
 	private:
 		Manager manager;
+
+		/** Seconds after which the heuristics stop with their best tour, 0 for no limit. */
+		double timeLimit = 0;
 	public:
 		void testManager();
+		void benchmarkMenu();
 		static void showMessage(std::string header, std::string body);
 
 		void mainMenu();
 		void selectorMenu();
 		void loaderScreen(DatasetType type, int option);
 		void resultMenu(HeuristicType type);
+		void compareMenu();
 
 		bool isTSPInvalid(ReturnDataTSP data);
 		bool isTSPFailed(ReturnDataTSP data);
 
-		Vertex *getBaseVertex();
+		int getBaseVertex();
+		bool confirmHeldKarp();
+		bool selectThreads();
+		void selectTimeLimit();
 };
 
 #endif
\ No newline at end of file